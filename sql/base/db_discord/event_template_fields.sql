@@ -0,0 +1,34 @@
+/*
+ Navicat Premium Data Transfer
+
+ Source Server         : #MariaDB_Local
+ Source Server Type    : MariaDB
+ Source Server Version : 100901
+ Source Host           : localhost:3306
+ Source Schema         : warhead_discord
+
+ Target Server Type    : MariaDB
+ Target Server Version : 100901
+ File Encoding         : 65001
+
+ Date: 18/10/2026 17:05:51
+*/
+
+SET NAMES utf8mb4;
+SET FOREIGN_KEY_CHECKS = 0;
+
+-- ----------------------------
+-- Table structure for event_template_fields
+-- ----------------------------
+DROP TABLE IF EXISTS `event_template_fields`;
+CREATE TABLE `event_template_fields`  (
+  `GuildID` bigint(20) NOT NULL DEFAULT 0,
+  `TemplateID` int(10) UNSIGNED NOT NULL DEFAULT 0,
+  `Index` tinyint(3) UNSIGNED NOT NULL DEFAULT 0,
+  `Name` varchar(256) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '',
+  `Value` varchar(1024) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '',
+  `IsInline` tinyint(1) NOT NULL DEFAULT 0,
+  PRIMARY KEY (`GuildID`, `TemplateID`, `Index`) USING BTREE
+) ENGINE = InnoDB CHARACTER SET = utf8mb4 COLLATE = utf8mb4_general_ci ROW_FORMAT = Dynamic;
+
+SET FOREIGN_KEY_CHECKS = 1;
@@ -0,0 +1,33 @@
+/*
+ Navicat Premium Data Transfer
+
+ Source Server         : #MariaDB_Local
+ Source Server Type    : MariaDB
+ Source Server Version : 100901
+ Source Host           : localhost:3306
+ Source Schema         : warhead_discord
+
+ Target Server Type    : MariaDB
+ Target Server Version : 100901
+ File Encoding         : 65001
+
+ Date: 18/10/2026 17:05:51
+*/
+
+SET NAMES utf8mb4;
+SET FOREIGN_KEY_CHECKS = 0;
+
+-- ----------------------------
+-- Table structure for event_templates
+-- ----------------------------
+DROP TABLE IF EXISTS `event_templates`;
+CREATE TABLE `event_templates`  (
+  `GuildID` bigint(20) NOT NULL DEFAULT 0,
+  `ID` int(10) UNSIGNED NOT NULL DEFAULT 0,
+  `Color` int(10) UNSIGNED NOT NULL DEFAULT 0,
+  `Title` varchar(256) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '',
+  `Description` text CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL,
+  PRIMARY KEY (`GuildID`, `ID`) USING BTREE
+) ENGINE = InnoDB CHARACTER SET = utf8mb4 COLLATE = utf8mb4_general_ci ROW_FORMAT = Dynamic;
+
+SET FOREIGN_KEY_CHECKS = 1;
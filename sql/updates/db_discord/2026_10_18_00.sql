@@ -0,0 +1,21 @@
+-- Event templates for CLIENT_SEND_EVENT
+DROP TABLE IF EXISTS `event_templates`;
+CREATE TABLE `event_templates`  (
+  `GuildID` bigint(20) NOT NULL DEFAULT 0,
+  `ID` int(10) UNSIGNED NOT NULL DEFAULT 0,
+  `Color` int(10) UNSIGNED NOT NULL DEFAULT 0,
+  `Title` varchar(256) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '',
+  `Description` text CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL,
+  PRIMARY KEY (`GuildID`, `ID`) USING BTREE
+) ENGINE = InnoDB CHARACTER SET = utf8mb4 COLLATE = utf8mb4_general_ci ROW_FORMAT = Dynamic;
+
+DROP TABLE IF EXISTS `event_template_fields`;
+CREATE TABLE `event_template_fields`  (
+  `GuildID` bigint(20) NOT NULL DEFAULT 0,
+  `TemplateID` int(10) UNSIGNED NOT NULL DEFAULT 0,
+  `Index` tinyint(3) UNSIGNED NOT NULL DEFAULT 0,
+  `Name` varchar(256) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '',
+  `Value` varchar(1024) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '',
+  `IsInline` tinyint(1) NOT NULL DEFAULT 0,
+  PRIMARY KEY (`GuildID`, `TemplateID`, `Index`) USING BTREE
+) ENGINE = InnoDB CHARACTER SET = utf8mb4 COLLATE = utf8mb4_general_ci ROW_FORMAT = Dynamic;
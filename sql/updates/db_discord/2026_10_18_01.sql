@@ -0,0 +1,2 @@
+-- IPv6 addresses and CIDR ranges in ip bans
+ALTER TABLE `ip_banned` MODIFY COLUMN `ip` varchar(49) CHARACTER SET utf8mb4 COLLATE utf8mb4_general_ci NOT NULL DEFAULT '127.0.0.1';
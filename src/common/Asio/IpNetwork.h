@@ -20,8 +20,11 @@
 
 #include "Define.h"
 #include "IpAddress.h"
+#include "Optional.h"
 #include <boost/asio/ip/network_v4.hpp>
 #include <boost/asio/ip/network_v6.hpp>
+#include <string>
+#include <string_view>
 
 namespace Warhead::Net
 {
@@ -58,6 +61,71 @@ namespace Warhead::Net
         boost::asio::ip::address_v6_range hosts = network.hosts();
         return hosts.find(clientAddress) != hosts.end();
     }
+
+    // IPv4 as v4-mapped IPv6, to keep both families in one address space
+    inline boost::asio::ip::address_v6 ToAddressV6(boost::asio::ip::address const& address)
+    {
+        if (address.is_v4())
+            return boost::asio::ip::make_address_v6(boost::asio::ip::v4_mapped, address.to_v4());
+
+        return address.to_v6();
+    }
+
+    // Address or CIDR range, "10.0.0.1", "10.0.0.0/8", "2001:db8::/32". IPv4 is v4-mapped
+    inline Optional<boost::asio::ip::network_v6> MakeNetworkV6(std::string_view network)
+    {
+        boost::system::error_code error;
+        std::size_t prefixPos = network.find('/');
+
+        boost::asio::ip::address address = boost::asio::ip::make_address(network.substr(0, prefixPos), error);
+        if (error)
+            return {};
+
+        uint16 maxPrefixLength = address.is_v4() ? 32 : 128;
+        uint16 prefixLength = maxPrefixLength;
+
+        if (prefixPos != std::string_view::npos)
+        {
+            std::string_view prefix = network.substr(prefixPos + 1);
+            if (prefix.empty() || prefix.size() > 3 || prefix.find_first_not_of("0123456789") != std::string_view::npos)
+                return {};
+
+            prefixLength = 0;
+            for (char digit : prefix)
+                prefixLength = prefixLength * 10 + (digit - '0');
+
+            if (prefixLength > maxPrefixLength)
+                return {};
+        }
+
+        if (address.is_v4())
+            prefixLength += 96;
+
+        return boost::asio::ip::make_network_v6(ToAddressV6(address), prefixLength).canonical();
+    }
+
+    // Text of network made by MakeNetworkV6, same for every notation of it: "10.0.0.5/8" -> "10.0.0.0/8", "10.0.0.1/32" -> "10.0.0.1"
+    inline std::string ToNetworkString(boost::asio::ip::network_v6 const& network)
+    {
+        boost::asio::ip::address_v6 address = network.network();
+        uint16 prefixLength = network.prefix_length();
+        uint16 maxPrefixLength = 128;
+        std::string result;
+
+        if (address.is_v4_mapped() && prefixLength >= 96)
+        {
+            result = boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, address).to_string();
+            prefixLength -= 96;
+            maxPrefixLength = 32;
+        }
+        else
+            result = address.to_string();
+
+        if (prefixLength != maxPrefixLength)
+            result += '/' + std::to_string(prefixLength);
+
+        return result;
+    }
 }
 
 #endif // IpNetwork_h__
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IpNetworkTrie_h__
+#define IpNetworkTrie_h__
+
+#include "IpNetwork.h"
+#include <array>
+#include <vector>
+
+namespace Warhead::Net
+{
+    // Binary radix trie of IPv6 networks (IPv4 as v4-mapped) with value per network.
+    // Lookup walks address bits once, cost doesn't depend on networks count
+    template<typename T>
+    class IpNetworkTrie
+    {
+    public:
+        IpNetworkTrie() { Clear(); }
+
+        void Clear()
+        {
+            _nodes.clear();
+            _nodes.emplace_back();
+            _freeNodes.clear();
+            _size = 0;
+        }
+
+        std::size_t Size() const { return _size; }
+
+        void Insert(boost::asio::ip::network_v6 const& network, T value)
+        {
+            auto bytes = network.network().to_bytes();
+            uint32 nodeIndex = 0;
+
+            for (uint16 bit = 0; bit < network.prefix_length(); ++bit)
+            {
+                uint8 direction = GetBit(bytes, bit);
+                uint32 childIndex = _nodes[nodeIndex].Children[direction];
+
+                if (!childIndex)
+                {
+                    childIndex = AllocateNode();
+                    _nodes[nodeIndex].Children[direction] = childIndex;
+                }
+
+                nodeIndex = childIndex;
+            }
+
+            if (!_nodes[nodeIndex].Value)
+                ++_size;
+
+            _nodes[nodeIndex].Value = std::move(value);
+        }
+
+        bool Remove(boost::asio::ip::network_v6 const& network)
+        {
+            auto bytes = network.network().to_bytes();
+            std::array<uint32, 129> path{};
+            uint32 nodeIndex = 0;
+
+            for (uint16 bit = 0; bit < network.prefix_length(); ++bit)
+            {
+                path[bit] = nodeIndex;
+                nodeIndex = _nodes[nodeIndex].Children[GetBit(bytes, bit)];
+
+                if (!nodeIndex)
+                    return false;
+            }
+
+            if (!_nodes[nodeIndex].Value)
+                return false;
+
+            _nodes[nodeIndex].Value.reset();
+            --_size;
+
+            // Free empty leaves up to the first used node
+            for (uint16 bit = network.prefix_length(); bit > 0; --bit)
+            {
+                Node& node = _nodes[nodeIndex];
+                if (node.Value || node.Children[0] || node.Children[1])
+                    break;
+
+                uint32 parentIndex = path[bit - 1];
+                _nodes[parentIndex].Children[GetBit(bytes, bit - 1)] = 0;
+                _freeNodes.push_back(nodeIndex);
+                nodeIndex = parentIndex;
+            }
+
+            return true;
+        }
+
+        T const* Find(boost::asio::ip::network_v6 const& network) const
+        {
+            auto bytes = network.network().to_bytes();
+            uint32 nodeIndex = 0;
+
+            for (uint16 bit = 0; bit < network.prefix_length(); ++bit)
+            {
+                nodeIndex = _nodes[nodeIndex].Children[GetBit(bytes, bit)];
+                if (!nodeIndex)
+                    return nullptr;
+            }
+
+            return _nodes[nodeIndex].Value ? &*_nodes[nodeIndex].Value : nullptr;
+        }
+
+        // First value from widest to narrowest network containing address, for which check returns true
+        template<typename Check>
+        T const* Match(boost::asio::ip::address_v6 const& address, Check&& check) const
+        {
+            auto bytes = address.to_bytes();
+            uint32 nodeIndex = 0;
+
+            for (uint16 bit = 0; ; ++bit)
+            {
+                Node const& node = _nodes[nodeIndex];
+                if (node.Value && check(*node.Value))
+                    return &*node.Value;
+
+                if (bit == 128)
+                    return nullptr;
+
+                nodeIndex = node.Children[GetBit(bytes, bit)];
+                if (!nodeIndex)
+                    return nullptr;
+            }
+        }
+
+    private:
+        struct Node
+        {
+            std::array<uint32, 2> Children{}; // 0 - no child, root is never a child
+            Optional<T> Value;
+        };
+
+        static uint8 GetBit(boost::asio::ip::address_v6::bytes_type const& bytes, uint16 bit)
+        {
+            return (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+        }
+
+        uint32 AllocateNode()
+        {
+            if (!_freeNodes.empty())
+            {
+                uint32 nodeIndex = _freeNodes.back();
+                _freeNodes.pop_back();
+                _nodes[nodeIndex] = Node();
+                return nodeIndex;
+            }
+
+            _nodes.emplace_back();
+            return static_cast<uint32>(_nodes.size() - 1);
+        }
+
+        std::vector<Node> _nodes;
+        std::vector<uint32> _freeNodes;
+        std::size_t _size{ 0 };
+    };
+}
+
+#endif // IpNetworkTrie_h__
@@ -0,0 +1,35 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Coroutine.h"
+#include "Log.h"
+
+void Warhead::Async::LogUnhandledException(std::exception_ptr exception)
+{
+    try
+    {
+        std::rethrow_exception(exception);
+    }
+    catch (std::exception const& error)
+    {
+        LOG_ERROR("server", "> Unhandled exception in coroutine: {}", error.what());
+    }
+    catch (...)
+    {
+        LOG_ERROR("server", "> Unhandled unknown exception in coroutine");
+    }
+}
@@ -0,0 +1,201 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WARHEAD_COROUTINE_H_
+#define _WARHEAD_COROUTINE_H_
+
+#include "Define.h"
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace Warhead::Async
+{
+    // Resumes a coroutine on the thread owning it
+    using Executor = std::function<void(std::coroutine_handle<>)>;
+
+    WH_COMMON_API void LogUnhandledException(std::exception_ptr exception);
+
+    template<typename T = void>
+    class Task;
+
+    namespace Impl
+    {
+        class PromiseBase
+        {
+        public:
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    PromiseBase& promise = handle.promise();
+
+                    // Awaiting task destroys the frame after reading the result
+                    if (promise._continuation)
+                        return promise._continuation;
+
+                    if (promise._detached)
+                    {
+                        if (promise._exception)
+                            LogUnhandledException(promise._exception);
+
+                        handle.destroy();
+                    }
+
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept { }
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() { _exception = std::current_exception(); }
+
+            Executor const& GetExecutor() const { return _executor; }
+
+        protected:
+            template<typename T> friend class Warhead::Async::Task;
+
+            Executor _executor;
+            std::coroutine_handle<> _continuation;
+            std::exception_ptr _exception;
+            bool _detached{ false };
+        };
+
+        template<typename T>
+        class Promise : public PromiseBase
+        {
+        public:
+            auto get_return_object() { return Task<T>(std::coroutine_handle<Promise>::from_promise(*this)); }
+
+            template<typename U>
+            void return_value(U&& value) { _value.emplace(std::forward<U>(value)); }
+
+            T GetResult()
+            {
+                if (_exception)
+                    std::rethrow_exception(_exception);
+
+                return std::move(*_value);
+            }
+
+        private:
+            std::optional<T> _value;
+        };
+
+        template<>
+        class Promise<void> : public PromiseBase
+        {
+        public:
+            auto get_return_object();
+            void return_void() const noexcept { }
+
+            void GetResult()
+            {
+                if (_exception)
+                    std::rethrow_exception(_exception);
+            }
+        };
+    }
+
+    // Lazy coroutine. Awaiting it runs it on the executor of the awaiting coroutine,
+    // Start runs it detached on the given executor
+    template<typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = Impl::Promise<T>;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) { }
+        Task(Task&& right) noexcept : _handle(std::exchange(right._handle, {})) { }
+
+        ~Task()
+        {
+            if (_handle)
+                _handle.destroy();
+        }
+
+        void Start(Executor executor)
+        {
+            auto handle = std::exchange(_handle, {});
+            handle.promise()._executor = std::move(executor);
+            handle.promise()._detached = true;
+            handle.resume();
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept
+        {
+            _handle.promise()._executor = awaiting.promise().GetExecutor();
+            _handle.promise()._continuation = awaiting;
+            return _handle;
+        }
+
+        T await_resume() { return _handle.promise().GetResult(); }
+
+    private:
+        Task(Task const&) = delete;
+        Task& operator=(Task const&) = delete;
+        Task& operator=(Task&&) = delete;
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    inline auto Impl::Promise<void>::get_return_object()
+    {
+        return Task<void>(std::coroutine_handle<Promise>::from_promise(*this));
+    }
+
+    // Awaits an operation reporting its result to a callback from any thread.
+    // Awaiting coroutine is resumed on its own executor
+    template<typename Result>
+    class CallbackAwaiter
+    {
+    public:
+        using Operation = std::function<void(std::function<void(Result)>&&)>;
+
+        explicit CallbackAwaiter(Operation&& operation) : _operation(std::move(operation)) { }
+
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            _operation([this, handle, executor = handle.promise().GetExecutor()](Result result)
+            {
+                _result.emplace(std::move(result));
+                executor(handle);
+            });
+        }
+
+        Result await_resume() { return std::move(*_result); }
+
+    private:
+        Operation _operation;
+        std::optional<Result> _result;
+    };
+}
+
+#endif
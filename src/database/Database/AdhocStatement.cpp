@@ -18,23 +18,26 @@
 #include "AdhocStatement.h"
 #include "Errors.h"
 #include "MySQLConnection.h"
+#include "QueryCompletion.h"
 #include "QueryResult.h"
 
 /*! Basic, ad-hoc queries. */
-BasicStatementTask::BasicStatementTask(std::string_view sql, bool async) : m_result(nullptr)
+BasicStatementTask::BasicStatementTask(std::string_view sql, bool async)
 {
     m_sql = std::string(sql);
     m_has_result = async; // If the operation is async, then there's a result
 
     if (async)
-        m_result = new QueryResultPromise();
+        m_completion = std::make_shared<QueryCompletion>(false);
 }
 
 BasicStatementTask::~BasicStatementTask()
 {
     m_sql.clear();
-    if (m_has_result && m_result)
-        delete m_result;
+
+    // Unexecuted task completes with empty result
+    if (m_completion)
+        m_completion->SetCompleted();
 }
 
 bool BasicStatementTask::Execute()
@@ -45,11 +48,11 @@ bool BasicStatementTask::Execute()
         if (!result || !result->GetRowCount() || !result->NextRow())
         {
             delete result;
-            m_result->set_value(QueryResult(nullptr));
+            m_completion->SetResult(QueryResult(nullptr));
             return false;
         }
 
-        m_result->set_value(QueryResult(result));
+        m_completion->SetResult(QueryResult(result));
         return true;
     }
 
@@ -30,12 +30,13 @@ public:
     ~BasicStatementTask();
 
     bool Execute() override;
-    QueryResultFuture GetFuture() const { return m_result->get_future(); }
+    std::shared_ptr<QueryCompletion> GetCompletion() const { return m_completion; }
+    QueryCompletion* GetQueryCompletion() const override { return m_completion.get(); }
 
 private:
     std::string m_sql; //- Raw query to be executed
     bool m_has_result;
-    QueryResultPromise* m_result;
+    std::shared_ptr<QueryCompletion> m_completion;
 };
 
 #endif
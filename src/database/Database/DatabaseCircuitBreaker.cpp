@@ -0,0 +1,80 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DatabaseCircuitBreaker.h"
+#include "Log.h"
+#include "Timer.h"
+#include <algorithm>
+
+void DatabaseCircuitBreaker::SetPolicy(std::size_t queueLimit, Seconds maxReconnectDelay, uint32 reconnectAttempts)
+{
+    _queueLimit = queueLimit;
+    _maxReconnectDelay = std::max<Seconds>(maxReconnectDelay, 1s);
+    _reconnectAttempts = reconnectAttempts;
+}
+
+void DatabaseCircuitBreaker::Trip()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_open)
+        return;
+
+    _openedAt = std::chrono::steady_clock::now();
+    _rejected = 0;
+    _open = true;
+
+    LOG_ERROR("sql.driver", "DatabasePool '{}': lost the MySQL server, interactive operations fail until reconnected, others are queued up to {}.",
+        _name, _queueLimit);
+}
+
+void DatabaseCircuitBreaker::Reset()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (!_open)
+        return;
+
+    _open = false;
+
+    LOG_INFO("sql.driver", "DatabasePool '{}': MySQL server is back after {}, {} operations were rejected meanwhile.",
+        _name, Warhead::Time::ToTimeString(std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - _openedAt)), _rejected.load());
+}
+
+bool DatabaseCircuitBreaker::Admit(SQLPriority priority, std::size_t queueSize)
+{
+    if (!IsOpen())
+        return true;
+
+    if (priority != SQLPriority::Interactive && queueSize < _queueLimit)
+        return true;
+
+    // Log the first one only, the total is logged on reset
+    if (!_rejected++)
+        LOG_WARN("sql.driver", "DatabasePool '{}': rejecting operations while the MySQL server is unreachable (backlog {}).", _name, queueSize);
+
+    return false;
+}
+
+Milliseconds DatabaseCircuitBreaker::GetReconnectDelay(uint32 attempt) const
+{
+    Milliseconds delay = 1s;
+
+    for (uint32 i = 1; i < attempt && delay < _maxReconnectDelay; ++i)
+        delay *= 2;
+
+    return std::min<Milliseconds>(delay, _maxReconnectDelay);
+}
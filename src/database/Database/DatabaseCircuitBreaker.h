@@ -0,0 +1,65 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _DATABASE_CIRCUIT_BREAKER_H
+#define _DATABASE_CIRCUIT_BREAKER_H
+
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+
+// Shared by all connections of a pool. Trips when a connection loses the server and resets
+// as soon as one reconnected. While open, new async queries are admitted by policy:
+// - interactive queries fail at once, someone is waiting for them
+// - other queries are queued until the pool backlog reaches the queue limit
+// Writes do not ask, they wait for the reconnect.
+class WH_DATABASE_API DatabaseCircuitBreaker
+{
+public:
+    explicit DatabaseCircuitBreaker(std::string_view name) : _name(name) { }
+
+    void SetPolicy(std::size_t queueLimit, Seconds maxReconnectDelay, uint32 reconnectAttempts);
+
+    void Trip();
+    void Reset();
+
+    [[nodiscard]] bool IsOpen() const { return _open.load(std::memory_order_relaxed); }
+
+    // Whether a new operation may be queued, queueSize is the current backlog of the pool
+    bool Admit(SQLPriority priority, std::size_t queueSize);
+
+    // Exponential backoff, capped at the configured reconnect delay
+    [[nodiscard]] Milliseconds GetReconnectDelay(uint32 attempt) const;
+
+    // 0 - reconnect until the server is back
+    [[nodiscard]] uint32 GetReconnectAttempts() const { return _reconnectAttempts; }
+
+private:
+    std::string _name;
+    std::atomic<bool> _open{ false };
+    std::atomic<uint64> _rejected{ 0 };
+
+    std::mutex _lock;
+    TimePoint _openedAt;
+
+    std::size_t _queueLimit{ 10000 };
+    Seconds _maxReconnectDelay{ 15s };
+    uint32 _reconnectAttempts{ 20 };
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "Field.h"
 #include "PreparedStatement.h"
 #include "QueryCallback.h"
+#include "QueryCallbackProcessor.h"
 #include "QueryResult.h"
 #include "Transaction.h"
 
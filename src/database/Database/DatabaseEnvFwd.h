@@ -18,16 +18,26 @@
 #ifndef DatabaseEnvFwd_h__
 #define DatabaseEnvFwd_h__
 
+#include "Define.h"
+#include <functional>
 #include <future>
 #include <memory>
 
+// Async operations are taken by class, Interactive first
+enum class SQLPriority : uint8
+{
+    Interactive,    // logins and other lookups someone is waiting for
+    Normal,
+    Bulk            // write-behind batches and maintenance
+};
+
+constexpr std::size_t MAX_SQL_PRIORITY = 3;
+
 struct QueryResultFieldMetadata;
 class Field;
 
 class ResultSet;
 using QueryResult = std::shared_ptr<ResultSet>;
-using QueryResultFuture = std::future<QueryResult>;
-using QueryResultPromise = std::promise<QueryResult>;
 
 class DiscordDatabaseConnection;
 
@@ -40,15 +50,11 @@ using DiscordDatabasePreparedStatement = PreparedStatement<DiscordDatabaseConnec
 
 class PreparedResultSet;
 using PreparedQueryResult = std::shared_ptr<PreparedResultSet>;
-using PreparedQueryResultFuture = std::future<PreparedQueryResult>;
-using PreparedQueryResultPromise = std::promise<PreparedQueryResult>;
+using PreparedResultChunkCallback = std::function<void(PreparedResultSet const&)>;
 
 class QueryCallback;
-
-template<typename T>
-class AsyncCallbackProcessor;
-
-using QueryCallbackProcessor = AsyncCallbackProcessor<QueryCallback>;
+class QueryCallbackProcessor;
+class QueryCompletion;
 
 class TransactionBase;
 
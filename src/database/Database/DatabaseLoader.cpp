@@ -55,7 +55,34 @@ DatabaseLoader& DatabaseLoader::AddDatabase(DatabaseWorkerPool<T>& pool, std::st
 
         uint8 const synchThreads = sConfigMgr->GetOption<uint8>(name + "Database.SynchThreads", 1);
 
-        pool.SetConnectionInfo(dbString, asyncThreads, synchThreads);
+        uint8 const reservedThreads = sConfigMgr->GetOption<uint8>(name + "Database.WorkerThreads.Interactive", 0);
+        if (reservedThreads >= asyncThreads)
+        {
+            LOG_ERROR(_logger, "{} database: interactive worker threads must be less than worker threads ({}).", name, asyncThreads);
+            return false;
+        }
+
+        uint8 maxAsyncThreads = sConfigMgr->GetOption<uint8>(name + "Database.WorkerThreads.Max", 0);
+        if (!maxAsyncThreads)
+            maxAsyncThreads = asyncThreads;
+
+        if (maxAsyncThreads < asyncThreads || maxAsyncThreads > 32)
+        {
+            LOG_ERROR(_logger, "{} database: invalid maximum number of worker threads specified. "
+                      "Please pick a value between {} and 32, or 0 to disable.", name, asyncThreads);
+            return false;
+        }
+
+        pool.SetConnectionInfo(dbString, asyncThreads, synchThreads, reservedThreads, maxAsyncThreads);
+        pool.SetAdaptiveWorkers(Milliseconds(sConfigMgr->GetOption<uint32>(name + "Database.WorkerThreads.WaitTarget", 50)),
+            Seconds(sConfigMgr->GetOption<uint32>(name + "Database.WorkerThreads.IdleTime", 60)));
+        pool.SetNonBlockingConnections(sConfigMgr->GetOption<uint8>(name + "Database.NonBlocking.Connections", 0));
+        pool.SetWriteBehind(Milliseconds(sConfigMgr->GetOption<uint32>(name + "Database.WriteBehind.Interval", 1000)),
+            sConfigMgr->GetOption<uint32>(name + "Database.WriteBehind.BatchSize", 100));
+        pool.SetCircuitBreaker(sConfigMgr->GetOption<uint32>(name + "Database.CircuitBreaker.QueueLimit", 10000),
+            Seconds(sConfigMgr->GetOption<uint8>("Database.Reconnect.Seconds", 15)), sConfigMgr->GetOption<uint8>("Database.Reconnect.Attempts", 20));
+        pool.SetSlowQuery(Milliseconds(sConfigMgr->GetOption<uint32>(name + "Database.SlowQuery.Threshold", 100)),
+            sConfigMgr->GetOption<uint32>(name + "Database.SlowQuery.Samples", 20));
 
         if (uint32 error = pool.Open())
         {
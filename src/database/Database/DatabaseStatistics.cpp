@@ -0,0 +1,161 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DatabaseStatistics.h"
+#include <algorithm>
+#include <bit>
+
+void LatencyHistogram::Add(Microseconds latency)
+{
+    uint64 const value = static_cast<uint64>(std::max<int64>(latency.count(), 0));
+    std::size_t const bucket = std::min<std::size_t>(std::bit_width(value), LATENCY_BUCKETS - 1);
+
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(value, std::memory_order_relaxed);
+
+    uint64 max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) { }
+}
+
+DatabaseLatencyStats LatencyHistogram::Collect()
+{
+    std::array<uint64, LATENCY_BUCKETS> buckets;
+    uint64 count = 0;
+
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i)
+    {
+        buckets[i] = _buckets[i].exchange(0, std::memory_order_relaxed);
+        count += buckets[i];
+    }
+
+    DatabaseLatencyStats stats;
+    stats.Count = count;
+    stats.Max = Microseconds(_max.exchange(0, std::memory_order_relaxed));
+
+    uint64 const total = _total.exchange(0, std::memory_order_relaxed);
+    if (!count)
+        return stats;
+
+    stats.Avg = Microseconds(total / count);
+
+    auto percentile = [&](uint64 rank)
+    {
+        uint64 seen = 0;
+
+        for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return std::min(Microseconds(i ? (uint64(1) << i) - 1 : 0), stats.Max);
+        }
+
+        return stats.Max;
+    };
+
+    stats.P50 = percentile((count + 1) / 2);
+    stats.P99 = percentile(std::max<uint64>(count * 99 / 100, 1));
+    return stats;
+}
+
+void DatabaseStatistics::Initialize(std::vector<std::string_view> const& queries)
+{
+    _statements.clear();
+    _statements.reserve(queries.size());
+
+    for (std::string_view query : queries)
+    {
+        auto& counters = _statements.emplace_back(std::make_unique<Counters>());
+        counters->Query = query;
+    }
+}
+
+void DatabaseStatistics::SetSlowThreshold(Microseconds threshold, std::size_t maxSamples)
+{
+    _slowThreshold = threshold;
+    _maxSlowSamples = maxSamples;
+}
+
+void DatabaseStatistics::Add(uint32 index, SQLStage stage, Microseconds latency)
+{
+    std::size_t const stageIndex = static_cast<std::size_t>(stage);
+
+    if (index < _statements.size())
+        _statements[index]->Stages[stageIndex].Add(latency);
+
+    _total.Stages[stageIndex].Add(latency);
+}
+
+void DatabaseStatistics::AddError(uint32 index)
+{
+    if (index < _statements.size())
+        _statements[index]->Errors.fetch_add(1, std::memory_order_relaxed);
+
+    _total.Errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DatabaseStatistics::AddSlowSample(uint32 index, Microseconds elapsed, std::string&& query)
+{
+    if (!_maxSlowSamples)
+        return;
+
+    std::lock_guard<std::mutex> guard(_slowLock);
+
+    if (_slowSamples.size() >= _maxSlowSamples)
+        _slowSamples.pop_front();
+
+    _slowSamples.push_back({ index, elapsed, std::chrono::system_clock::now(), std::move(query) });
+}
+
+std::vector<DatabaseStatementStats> DatabaseStatistics::CollectStatements()
+{
+    std::vector<DatabaseStatementStats> result;
+
+    for (uint32 i = 0; i < _statements.size(); ++i)
+    {
+        DatabaseStatementStats stats = Collect(i, *_statements[i]);
+        if (stats.Errors || std::any_of(stats.Stages.begin(), stats.Stages.end(), [](DatabaseLatencyStats const& stage) { return stage.Count; }))
+            result.emplace_back(stats);
+    }
+
+    return result;
+}
+
+DatabaseStatementStats DatabaseStatistics::CollectTotal()
+{
+    return Collect(0, _total);
+}
+
+std::vector<DatabaseSlowStatement> DatabaseStatistics::CollectSlowSamples()
+{
+    std::lock_guard<std::mutex> guard(_slowLock);
+
+    std::vector<DatabaseSlowStatement> result(std::make_move_iterator(_slowSamples.begin()), std::make_move_iterator(_slowSamples.end()));
+    _slowSamples.clear();
+    return result;
+}
+
+DatabaseStatementStats DatabaseStatistics::Collect(uint32 index, Counters& counters)
+{
+    DatabaseStatementStats stats;
+    stats.Index = index;
+    stats.Query = counters.Query;
+    stats.Errors = counters.Errors.exchange(0, std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < MAX_SQL_STAGE; ++i)
+        stats.Stages[i] = counters.Stages[i].Collect();
+
+    return stats;
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _DATABASE_STATISTICS_H
+#define _DATABASE_STATISTICS_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class SQLStage : uint8
+{
+    QueueWait,  // enqueued until a connection picked it up
+    Execute,    // bind, send and server side execution
+    Decode,     // result transfer and buffering
+    Max
+};
+
+constexpr std::size_t MAX_SQL_STAGE = static_cast<std::size_t>(SQLStage::Max);
+
+// Bucket i counts latencies below 2^i microseconds, the last one is open-ended (~16s)
+constexpr std::size_t LATENCY_BUCKETS = 25;
+
+struct DatabaseLatencyStats
+{
+    uint64 Count{ 0 };
+    Microseconds Avg{ 0 };
+    Microseconds P50{ 0 };
+    Microseconds P99{ 0 };
+    Microseconds Max{ 0 };
+};
+
+struct DatabaseStatementStats
+{
+    uint32 Index{ 0 };
+    std::string_view Query;
+    uint64 Errors{ 0 };
+    std::array<DatabaseLatencyStats, MAX_SQL_STAGE> Stages;
+
+    [[nodiscard]] DatabaseLatencyStats const& Get(SQLStage stage) const { return Stages[static_cast<std::size_t>(stage)]; }
+};
+
+struct DatabaseSlowStatement
+{
+    uint32 Index{ 0 };
+    Microseconds Elapsed{ 0 };
+    SystemTimePoint Time;
+    std::string Query;  // with parameters
+};
+
+// Lock-free log2 histogram, percentiles are bucket upper bounds
+class WH_DATABASE_API LatencyHistogram
+{
+public:
+    void Add(Microseconds latency);
+
+    // Counters are reset on every call
+    DatabaseLatencyStats Collect();
+
+private:
+    std::array<std::atomic<uint64>, LATENCY_BUCKETS> _buckets{};
+    std::atomic<uint64> _total{ 0 };
+    std::atomic<uint64> _max{ 0 };
+};
+
+// Always-on counters of the prepared statements of one pool, per statement index and in total
+class WH_DATABASE_API DatabaseStatistics
+{
+public:
+    DatabaseStatistics() = default;
+
+    // Sized once the statements are prepared, before any of them is executed
+    void Initialize(std::vector<std::string_view> const& queries);
+    void SetSlowThreshold(Microseconds threshold, std::size_t maxSamples);
+
+    void Add(uint32 index, SQLStage stage, Microseconds latency);
+    void AddError(uint32 index);
+
+    [[nodiscard]] bool IsSlow(Microseconds elapsed) const { return _slowThreshold.count() && elapsed >= _slowThreshold; }
+    void AddSlowSample(uint32 index, Microseconds elapsed, std::string&& query);
+
+    // Counters are reset on every call, statements without executions are skipped
+    std::vector<DatabaseStatementStats> CollectStatements();
+    DatabaseStatementStats CollectTotal();
+    std::vector<DatabaseSlowStatement> CollectSlowSamples();
+
+private:
+    struct Counters
+    {
+        std::array<LatencyHistogram, MAX_SQL_STAGE> Stages;
+        std::atomic<uint64> Errors{ 0 };
+        std::string Query;
+    };
+
+    DatabaseStatementStats Collect(uint32 index, Counters& counters);
+
+    std::vector<std::unique_ptr<Counters>> _statements;
+    Counters _total;
+
+    Microseconds _slowThreshold{ 0 };
+    std::size_t _maxSlowSamples{ 0 };
+    std::mutex _slowLock;
+    std::deque<DatabaseSlowStatement> _slowSamples;
+};
+
+#endif
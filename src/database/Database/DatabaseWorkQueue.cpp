@@ -0,0 +1,322 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseWorkQueue.h"
+#include "Errors.h"
+#include "MPSCQueue.h"
+#include "SQLOperation.h"
+
+struct DatabaseWorkQueue::Lane
+{
+    std::array<MPSCQueue<SQLOperation>, MAX_SQL_PRIORITY> Shared;
+    MPSCQueue<SQLOperation> Pinned;
+
+    // Single consumer guards for the shared queues, held by owner or thief
+    std::array<std::atomic_flag, MAX_SQL_PRIORITY> SharedConsumer;
+
+    std::atomic<std::size_t> PinnedCount{ 0 };
+    std::atomic<bool> Canceled{ false };
+    std::atomic<bool> Active{ true };
+};
+
+DatabaseWorkQueue::DatabaseWorkQueue(std::size_t laneCount, std::size_t reservedLanes, std::size_t fixedLanes) :
+    _reservedLanes(reservedLanes), _fixedLanes(fixedLanes ? fixedLanes : laneCount), _activeLanes(_fixedLanes)
+{
+    ASSERT(_fixedLanes && _fixedLanes <= laneCount, "Worker threads are validated by DatabaseLoader");
+    ASSERT(reservedLanes < _fixedLanes);
+
+    _lanes.reserve(laneCount);
+
+    for (std::size_t i = 0; i < laneCount; ++i)
+    {
+        _lanes.emplace_back(std::make_unique<Lane>());
+        _lanes.back()->Active = i < _fixedLanes;
+    }
+}
+
+DatabaseWorkQueue::~DatabaseWorkQueue() = default;
+
+void DatabaseWorkQueue::Push(SQLOperation* op)
+{
+    // op belongs to a worker as soon as it is enqueued
+    SQLPriority const priority = op->m_priority;
+    auto const index = static_cast<std::size_t>(priority);
+    auto& lane = _lanes[_nextLane.fetch_add(1, std::memory_order_relaxed) % _activeLanes];
+
+    op->m_queueTime = std::chrono::steady_clock::now();
+    _classes[index].Depth.fetch_add(1);
+    lane->Shared[index].Enqueue(op);
+    _classes[index].Shared.fetch_add(1);
+
+    // A reserved worker would swallow a single wake up for work it may not take
+    Notify(_reservedLanes && priority != SQLPriority::Interactive);
+}
+
+void DatabaseWorkQueue::PushPinned(std::size_t lane, SQLOperation* op)
+{
+    ASSERT(lane < _lanes.size());
+
+    op->m_queueTime = std::chrono::steady_clock::now();
+    _classes[static_cast<std::size_t>(op->m_priority)].Depth.fetch_add(1);
+    _lanes[lane]->Pinned.Enqueue(op);
+    _lanes[lane]->PinnedCount.fetch_add(1);
+
+    // Only the owner can take it, wake everybody so the owner is not missed
+    Notify(true);
+}
+
+bool DatabaseWorkQueue::WaitAndPop(std::size_t lane, SQLOperation*& op)
+{
+    for (;;)
+    {
+        // A canceled lane still hands out its work, so nothing pinned to it is lost on shutdown
+        if (TryPop(lane, op))
+        {
+            OnPop(op);
+            return true;
+        }
+
+        if (_lanes[lane]->Canceled)
+            return false;
+
+        std::unique_lock<std::mutex> lock(_sleepLock);
+        _sleepers.fetch_add(1);
+        _sleepCondition.wait(lock, [this, lane]() { return _lanes[lane]->Canceled || HasWork(lane); });
+        _sleepers.fetch_sub(1);
+    }
+}
+
+void DatabaseWorkQueue::Open(std::size_t lane)
+{
+    _lanes[lane]->Canceled = false;
+}
+
+void DatabaseWorkQueue::Cancel(std::size_t lane)
+{
+    _lanes[lane]->Canceled = true;
+
+    std::lock_guard<std::mutex> lock(_sleepLock);
+    _sleepCondition.notify_all();
+}
+
+void DatabaseWorkQueue::Cancel()
+{
+    for (auto& lane : _lanes)
+        lane->Canceled = true;
+
+    std::lock_guard<std::mutex> lock(_sleepLock);
+    _sleepCondition.notify_all();
+}
+
+std::size_t DatabaseWorkQueue::Clear()
+{
+    std::size_t cleared = 0;
+    SQLOperation* op = nullptr;
+
+    auto drop = [this, &cleared](SQLOperation* dropped)
+    {
+        // Unexecuted operations complete with an empty result
+        _classes[static_cast<std::size_t>(dropped->m_priority)].Depth.fetch_sub(1);
+        delete dropped;
+        ++cleared;
+    };
+
+    for (auto& lane : _lanes)
+    {
+        for (std::size_t i = 0; i < MAX_SQL_PRIORITY; ++i)
+        {
+            while (lane->Shared[i].Dequeue(op))
+            {
+                _classes[i].Shared.fetch_sub(1);
+                drop(op);
+            }
+        }
+
+        while (lane->Pinned.Dequeue(op))
+        {
+            lane->PinnedCount.fetch_sub(1);
+            drop(op);
+        }
+    }
+
+    return cleared;
+}
+
+void DatabaseWorkQueue::ActivateLane()
+{
+    std::size_t const lane = _activeLanes;
+    ASSERT(lane < _lanes.size());
+
+    _lanes[lane]->Active = true;
+    _activeLanes.fetch_add(1);
+
+    std::lock_guard<std::mutex> lock(_sleepLock);
+    _sleepCondition.notify_all();
+}
+
+void DatabaseWorkQueue::DeactivateLane()
+{
+    std::size_t const lane = _activeLanes - 1;
+    ASSERT(lane >= _fixedLanes);
+
+    // Whatever producers still push to it is stolen by the remaining lanes
+    _activeLanes.fetch_sub(1);
+    _lanes[lane]->Active = false;
+}
+
+std::size_t DatabaseWorkQueue::Size() const
+{
+    std::size_t size = 0;
+
+    for (auto const& state : _classes)
+        size += state.Depth;
+
+    return size;
+}
+
+DatabaseQueueStats DatabaseWorkQueue::CollectStats(SQLPriority priority)
+{
+    ClassState& state = _classes[static_cast<std::size_t>(priority)];
+
+    DatabaseQueueStats stats;
+    stats.Depth = state.Depth;
+    stats.Executed = state.Executed.exchange(0);
+    stats.MaxWait = Microseconds(state.WaitMax.exchange(0));
+
+    uint64 const waitTotal = state.WaitTotal.exchange(0);
+    if (stats.Executed)
+        stats.AvgWait = Microseconds(waitTotal / stats.Executed);
+
+    return stats;
+}
+
+DatabaseQueueStats DatabaseWorkQueue::CollectLoad()
+{
+    DatabaseQueueStats stats;
+    stats.Depth = Size();
+    stats.Executed = _loadExecuted.exchange(0);
+    stats.MaxWait = Microseconds(_loadWaitMax.exchange(0));
+
+    uint64 const waitTotal = _loadWaitTotal.exchange(0);
+    if (stats.Executed)
+        stats.AvgWait = Microseconds(waitTotal / stats.Executed);
+
+    return stats;
+}
+
+bool DatabaseWorkQueue::TryPop(std::size_t lane, SQLOperation*& op)
+{
+    Lane& own = *_lanes[lane];
+
+    // A deactivated lane only drains its pinned work while its worker stops
+    if (!own.Active)
+        return own.Canceled && TryPopPinned(own, op);
+
+    if (TryPopShared(lane, SQLPriority::Interactive, op))
+        return true;
+
+    if (TryPopPinned(own, op))
+        return true;
+
+    if (IsReserved(lane))
+        return false;
+
+    return TryPopShared(lane, SQLPriority::Normal, op) || TryPopShared(lane, SQLPriority::Bulk, op);
+}
+
+bool DatabaseWorkQueue::TryPopPinned(Lane& lane, SQLOperation*& op)
+{
+    if (!lane.PinnedCount || !lane.Pinned.Dequeue(op))
+        return false;
+
+    lane.PinnedCount.fetch_sub(1);
+    return true;
+}
+
+bool DatabaseWorkQueue::TryPopShared(std::size_t lane, SQLPriority priority, SQLOperation*& op)
+{
+    auto const index = static_cast<std::size_t>(priority);
+    ClassState& state = _classes[index];
+
+    // Own shared queue first, then steal from the neighbours
+    for (std::size_t i = 0; i < _lanes.size() && state.Shared; ++i)
+    {
+        Lane& victim = *_lanes[(lane + i) % _lanes.size()];
+
+        if (victim.SharedConsumer[index].test_and_set(std::memory_order_acquire))
+            continue;
+
+        bool result = victim.Shared[index].Dequeue(op);
+        victim.SharedConsumer[index].clear(std::memory_order_release);
+
+        if (result)
+        {
+            state.Shared.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DatabaseWorkQueue::HasWork(std::size_t lane) const
+{
+    if (!_lanes[lane]->Active)
+        return false;
+
+    if (_lanes[lane]->PinnedCount || _classes[static_cast<std::size_t>(SQLPriority::Interactive)].Shared)
+        return true;
+
+    if (IsReserved(lane))
+        return false;
+
+    return _classes[static_cast<std::size_t>(SQLPriority::Normal)].Shared || _classes[static_cast<std::size_t>(SQLPriority::Bulk)].Shared;
+}
+
+void DatabaseWorkQueue::OnPop(SQLOperation* op)
+{
+    ClassState& state = _classes[static_cast<std::size_t>(op->m_priority)];
+
+    uint64 const wait = std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - op->m_queueTime).count();
+
+    state.Depth.fetch_sub(1);
+    state.Executed.fetch_add(1, std::memory_order_relaxed);
+    state.WaitTotal.fetch_add(wait, std::memory_order_relaxed);
+
+    uint64 max = state.WaitMax.load(std::memory_order_relaxed);
+    while (wait > max && !state.WaitMax.compare_exchange_weak(max, wait, std::memory_order_relaxed)) { }
+
+    _loadExecuted.fetch_add(1, std::memory_order_relaxed);
+    _loadWaitTotal.fetch_add(wait, std::memory_order_relaxed);
+
+    max = _loadWaitMax.load(std::memory_order_relaxed);
+    while (wait > max && !_loadWaitMax.compare_exchange_weak(max, wait, std::memory_order_relaxed)) { }
+}
+
+void DatabaseWorkQueue::Notify(bool all)
+{
+    // Pairs with the sleeper count taken under _sleepLock in WaitAndPop
+    if (!_sleepers)
+        return;
+
+    std::lock_guard<std::mutex> lock(_sleepLock);
+
+    if (all)
+        _sleepCondition.notify_all();
+    else
+        _sleepCondition.notify_one();
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASE_WORK_QUEUE_H
+#define _DATABASE_WORK_QUEUE_H
+
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class SQLOperation;
+
+struct DatabaseQueueStats
+{
+    std::size_t Depth{ 0 };
+    uint64 Executed{ 0 };
+    Microseconds AvgWait{ 0 };
+    Microseconds MaxWait{ 0 };
+};
+
+// One lane per async connection. Every lane has lock-free queues per priority class:
+// - shared: any idle worker may steal from it
+// - pinned: only the lane owner pops it, so operations keep their order
+// Pinned operations are ordered only against each other: interactive shared work, e.g a read of the same row, may run before an older pinned write.
+// The first fixedLanes lanes always have a worker, the last reservedLanes of them only run interactive and pinned operations.
+// Lanes above fixedLanes are elastic: they take shared work and their own keep-alive pings, and are activated from the bottom up.
+class WH_DATABASE_API DatabaseWorkQueue
+{
+public:
+    DatabaseWorkQueue(std::size_t laneCount, std::size_t reservedLanes, std::size_t fixedLanes = 0);
+    ~DatabaseWorkQueue();
+
+    [[nodiscard]] std::size_t GetLaneCount() const { return _lanes.size(); }
+    [[nodiscard]] std::size_t GetFixedLaneCount() const { return _fixedLanes; }
+    [[nodiscard]] std::size_t GetActiveLaneCount() const { return _activeLanes; }
+    [[nodiscard]] std::size_t GetLane(uint64 orderKey) const { return orderKey % _fixedLanes; }
+
+    void Push(SQLOperation* op);
+    void PushPinned(std::size_t lane, SQLOperation* op);
+
+    // Blocks until the lane has work or is canceled, returns false once canceled and drained
+    bool WaitAndPop(std::size_t lane, SQLOperation*& op);
+
+    void Open(std::size_t lane);
+    void Cancel(std::size_t lane);
+    void Cancel();
+
+    // Deletes everything still queued, no worker may run. Returns the number of deleted operations
+    std::size_t Clear();
+
+    // Elastic lanes only, the worker must be ready before and idle workers stop taking work after
+    void ActivateLane();
+    void DeactivateLane();
+
+    [[nodiscard]] std::size_t Size() const;
+
+    // Wait counters are reset on every call, depth is the current one
+    DatabaseQueueStats CollectStats(SQLPriority priority);
+
+    // Same over all priorities with own counters, so sampling it does not disturb CollectStats
+    DatabaseQueueStats CollectLoad();
+
+private:
+    struct Lane;
+
+    struct ClassState
+    {
+        std::atomic<std::size_t> Shared{ 0 };
+        std::atomic<std::size_t> Depth{ 0 };
+        std::atomic<uint64> Executed{ 0 };
+        std::atomic<uint64> WaitTotal{ 0 };
+        std::atomic<uint64> WaitMax{ 0 };
+    };
+
+    bool TryPop(std::size_t lane, SQLOperation*& op);
+    bool TryPopPinned(Lane& lane, SQLOperation*& op);
+    bool TryPopShared(std::size_t lane, SQLPriority priority, SQLOperation*& op);
+    [[nodiscard]] bool HasWork(std::size_t lane) const;
+    [[nodiscard]] bool IsReserved(std::size_t lane) const { return lane < _fixedLanes && lane >= _fixedLanes - _reservedLanes; }
+    void OnPop(SQLOperation* op);
+    void Notify(bool all);
+
+    std::vector<std::unique_ptr<Lane>> _lanes;
+    std::size_t _reservedLanes;
+    std::size_t _fixedLanes;
+    std::atomic<std::size_t> _activeLanes;
+    std::atomic<std::size_t> _nextLane{ 0 };
+    std::array<ClassState, MAX_SQL_PRIORITY> _classes;
+
+    std::atomic<uint64> _loadExecuted{ 0 };
+    std::atomic<uint64> _loadWaitTotal{ 0 };
+    std::atomic<uint64> _loadWaitMax{ 0 };
+
+    // Idle workers sleep here, producers only lock it when somebody sleeps
+    std::mutex _sleepLock;
+    std::condition_variable _sleepCondition;
+    std::atomic<uint32> _sleepers{ 0 };
+
+    DatabaseWorkQueue(DatabaseWorkQueue const&) = delete;
+    DatabaseWorkQueue& operator=(DatabaseWorkQueue const&) = delete;
+};
+
+#endif // _DATABASE_WORK_QUEUE_H
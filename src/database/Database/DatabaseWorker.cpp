@@ -16,22 +16,21 @@
  */
 
 #include "DatabaseWorker.h"
-#include "PCQueue.h"
+#include "DatabaseWorkQueue.h"
 #include "SQLOperation.h"
 
-DatabaseWorker::DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection)
+DatabaseWorker::DatabaseWorker(DatabaseWorkQueue* newQueue, std::size_t lane, MySQLConnection* connection)
 {
     _connection = connection;
     _queue = newQueue;
-    _cancelationToken = false;
+    _lane = lane;
+    _queue->Open(_lane);
     _workerThread = std::thread(&DatabaseWorker::WorkerThread, this);
 }
 
 DatabaseWorker::~DatabaseWorker()
 {
-    _cancelationToken = true;
-
-    _queue->Cancel();
+    _queue->Cancel(_lane);
 
     _workerThread.join();
 }
@@ -45,9 +44,10 @@ void DatabaseWorker::WorkerThread()
     {
         SQLOperation* operation = nullptr;
 
-        _queue->WaitAndPop(operation);
+        if (!_queue->WaitAndPop(_lane, operation))
+            return;
 
-        if (_cancelationToken || !operation)
+        if (!operation)
             return;
 
         operation->SetConnection(_connection);
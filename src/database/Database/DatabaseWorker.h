@@ -19,30 +19,26 @@
 #define _WORKERTHREAD_H
 
 #include "Define.h"
-#include <atomic>
 #include <thread>
 
-template <typename T>
-class ProducerConsumerQueue;
-
+class DatabaseWorkQueue;
 class MySQLConnection;
 class SQLOperation;
 
 class WH_DATABASE_API DatabaseWorker
 {
 public:
-    DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection);
+    DatabaseWorker(DatabaseWorkQueue* newQueue, std::size_t lane, MySQLConnection* connection);
     ~DatabaseWorker();
 
 private:
-    ProducerConsumerQueue<SQLOperation*>* _queue;
+    DatabaseWorkQueue* _queue;
+    std::size_t _lane;
     MySQLConnection* _connection;
 
     void WorkerThread();
     std::thread _workerThread;
 
-    std::atomic<bool> _cancelationToken;
-
     DatabaseWorker(DatabaseWorker const& right) = delete;
     DatabaseWorker& operator=(DatabaseWorker const& right) = delete;
 };
@@ -17,18 +17,23 @@
 
 #include "DatabaseWorkerPool.h"
 #include "AdhocStatement.h"
+#include "DatabaseCircuitBreaker.h"
+#include "DatabaseStatistics.h"
+#include "DatabaseWorkQueue.h"
 #include "DiscordDatabase.h"
 #include "Errors.h"
 #include "Log.h"
+#include "MySQLNonBlockingDriver.h"
 #include "MySQLPreparedStatement.h"
 #include "MySQLWorkaround.h"
-#include "PCQueue.h"
 #include "PreparedStatement.h"
 #include "QueryCallback.h"
+#include "QueryCompletion.h"
 #include "QueryHolder.h"
 #include "QueryResult.h"
 #include "SQLOperation.h"
 #include "Transaction.h"
+#include <algorithm>
 #include <limits>
 #include <mysqld_error.h>
 
@@ -45,6 +50,10 @@
 #define MIN_MYSQL_CLIENT_VERSION 50700u
 #endif
 
+//! Adaptive workers sample the queue this often, and grow after this many busy samples in a row
+constexpr Seconds ADAPTIVE_SAMPLE_INTERVAL = 1s;
+constexpr uint32 ADAPTIVE_GROW_SAMPLES = 2;
+
 class PingOperation : public SQLOperation
 {
     //! Operation for idle delaythreads
@@ -57,7 +66,6 @@ class PingOperation : public SQLOperation
 
 template <class T>
 DatabaseWorkerPool<T>::DatabaseWorkerPool() :
-    _queue(new ProducerConsumerQueue<SQLOperation*>()),
     _async_threads(0),
     _synch_threads(0)
 {
@@ -79,16 +87,49 @@ DatabaseWorkerPool<T>::DatabaseWorkerPool() :
 template <class T>
 DatabaseWorkerPool<T>::~DatabaseWorkerPool()
 {
-    _queue->Cancel();
+    StopSizer();
+
+    if (_queue)
+        _queue->Cancel();
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::SetConnectionInfo(std::string_view infoString, uint8 const asyncThreads, uint8 const synchThreads)
+void DatabaseWorkerPool<T>::SetConnectionInfo(std::string_view infoString, uint8 const asyncThreads, uint8 const synchThreads, uint8 const reservedThreads /*= 0*/, uint8 const maxAsyncThreads /*= 0*/)
 {
     _connectionInfo = std::make_unique<MySQLConnectionInfo>(infoString);
 
     _async_threads = asyncThreads;
     _synch_threads = synchThreads;
+
+    _queue = std::make_unique<DatabaseWorkQueue>(std::max(_async_threads, maxAsyncThreads), reservedThreads, _async_threads);
+    _breaker = std::make_unique<DatabaseCircuitBreaker>(_connectionInfo->database);
+    _statistics = std::make_unique<DatabaseStatistics>();
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::SetSlowQuery(Milliseconds threshold, uint32 maxSamples)
+{
+    _statistics->SetSlowThreshold(threshold, maxSamples);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::SetCircuitBreaker(std::size_t queueLimit, Seconds maxReconnectDelay, uint32 reconnectAttempts)
+{
+    _breaker->SetPolicy(queueLimit, maxReconnectDelay, reconnectAttempts);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::SetAdaptiveWorkers(Milliseconds waitTarget, Seconds idleTime)
+{
+    _waitTarget = waitTarget;
+    _idleTime = std::max<Seconds>(ADAPTIVE_SAMPLE_INTERVAL, idleTime);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::SetWriteBehind(Milliseconds interval, uint32 maxBatchSize)
+{
+    _batchInterval = interval;
+    _batchMaxSize = std::max<uint32>(1, maxBatchSize);
 }
 
 template <class T>
@@ -106,10 +147,27 @@ uint32 DatabaseWorkerPool<T>::Open()
 
     error = OpenConnections(IDX_SYNCH, _synch_threads);
 
+    if (!error && _nonBlockingConnections)
+    {
+        if (!MySQLNonBlockingDriver::IsSupported())
+        {
+            LOG_WARN("sql.driver", "DatabasePool '{}': client library has no non-blocking API, prepared statements stay on worker threads.", GetDatabaseName());
+        }
+        else if (!(error = OpenConnections(IDX_NON_BLOCKING, _nonBlockingConnections)))
+        {
+            _nonBlocking = std::make_unique<MySQLNonBlockingDriver>();
+
+            for (auto const& connection : _connections[IDX_NON_BLOCKING])
+                _nonBlocking->AddConnection(connection.get());
+
+            _nonBlocking->Start();
+        }
+    }
+
     if (!error)
     {
         LOG_INFO("sql.driver", "DatabasePool '{}' opened successfully. {} total connections running.",
-            GetDatabaseName(), (_connections[IDX_SYNCH].size() + _connections[IDX_ASYNC].size()));
+            GetDatabaseName(), (_connections[IDX_SYNCH].size() + _connections[IDX_ASYNC].size() + _connections[IDX_NON_BLOCKING].size()));
     }
 
     LOG_INFO("sql.driver", "");
@@ -122,9 +180,26 @@ void DatabaseWorkerPool<T>::Close()
 {
     LOG_INFO("sql.driver", "Closing down DatabasePool '{}'.", GetDatabaseName());
 
+    //! Hand the pending write-behind batch to the workers, they drain their lanes before they go away
+    FlushBatched(true);
+
+    //! Finishes statements in flight, the driver must be gone before its connections
+    _nonBlocking.reset();
+    _connections[IDX_NON_BLOCKING].clear();
+
+    //! Elastic connections first, their shared work is left to the fixed workers
+    StopSizer();
+
+    while (!_elasticConnections.empty())
+        RemoveElasticConnection();
+
     //! Closes the actualy MySQL connection.
     _connections[IDX_ASYNC].clear();
 
+    //! Workers drain their lanes, only work enqueued after that is left
+    if (std::size_t dropped = _queue->Clear())
+        LOG_ERROR("sql.driver", "DatabasePool '{}': dropped {} operations enqueued while closing.", GetDatabaseName(), dropped);
+
     LOG_INFO("sql.driver", "Asynchronous connections on DatabasePool '{}' terminated. Proceeding with synchronous connections.",
         GetDatabaseName());
 
@@ -178,6 +253,27 @@ bool DatabaseWorkerPool<T>::PrepareStatements()
         }
     }
 
+    //! Statement text per index, each connection only has the statements of its own type
+    std::vector<std::string_view> queries(_preparedStatementSize.size());
+    for (auto const& connections : _connections)
+        for (auto const& connection : connections)
+            for (std::size_t i = 0; i < connection->m_stmts.size(); ++i)
+                if (MySQLPreparedStatement* stmt = connection->m_stmts[i].get())
+                    queries[i] = stmt->GetQuery();
+
+    _statistics->Initialize(queries);
+    _statementPool = std::make_unique<PreparedStatementPool>(_preparedStatementSize.size());
+
+    //! Elastic connections prepare their statements themselves, start sizing once the pool is complete
+    if (_queue->GetLaneCount() > _async_threads && !_sizerThread.joinable())
+    {
+        LOG_INFO("sql.driver", "DatabasePool '{}': asynchronous connections adapt between {} and {}.",
+            GetDatabaseName(), _async_threads, _queue->GetLaneCount());
+
+        _sizerStop = false;
+        _sizerThread = std::thread(&DatabaseWorkerPool<T>::SizerThread, this);
+    }
+
     return true;
 }
 
@@ -205,8 +301,8 @@ PreparedQueryResult DatabaseWorkerPool<T>::Query(PreparedStatement<T>* stmt)
     PreparedResultSet* ret = connection->Query(stmt);
     connection->Unlock();
 
-    //! Delete proxy-class. Not needed anymore
-    delete stmt;
+    //! Release proxy-class. Not needed anymore
+    PreparedStatementBase::Free(stmt);
 
     if (!ret || !ret->GetRowCount())
     {
@@ -218,23 +314,36 @@ PreparedQueryResult DatabaseWorkerPool<T>::Query(PreparedStatement<T>* stmt)
 }
 
 template <class T>
-QueryCallback DatabaseWorkerPool<T>::AsyncQuery(std::string_view sql)
+uint64 DatabaseWorkerPool<T>::QueryStream(PreparedStatement<T>* stmt, PreparedResultChunkCallback const& callback, uint32 chunkRows /*= 1024*/)
+{
+    auto connection = GetFreeConnection();
+    uint64 rows = connection->QueryStream(stmt, chunkRows, callback);
+    connection->Unlock();
+
+    //! Release proxy-class. Not needed anymore
+    PreparedStatementBase::Free(stmt);
+
+    return rows;
+}
+
+template <class T>
+QueryCallback DatabaseWorkerPool<T>::AsyncQuery(std::string_view sql, SQLPriority priority /*= SQLPriority::Normal*/)
 {
     BasicStatementTask* task = new BasicStatementTask(sql, true);
-    // Store future result before enqueueing - task might get already processed and deleted before returning from this method
-    QueryResultFuture result = task->GetFuture();
-    Enqueue(task);
-    return QueryCallback(std::move(result));
+    // Store completion before enqueueing - task might get already processed and deleted before returning from this method
+    std::shared_ptr<QueryCompletion> completion = task->GetCompletion();
+    Enqueue(task, priority);
+    return QueryCallback(std::move(completion));
 }
 
 template <class T>
-QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt)
+QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt, SQLPriority priority /*= SQLPriority::Normal*/)
 {
     PreparedStatementTask* task = new PreparedStatementTask(stmt, true);
-    // Store future result before enqueueing - task might get already processed and deleted before returning from this method
-    PreparedQueryResultFuture result = task->GetFuture();
-    Enqueue(task);
-    return QueryCallback(std::move(result));
+    // Store completion before enqueueing - task might get already processed and deleted before returning from this method
+    std::shared_ptr<QueryCompletion> completion = task->GetCompletion();
+    EnqueuePrepared(task, priority);
+    return QueryCallback(std::move(completion));
 }
 
 template <class T>
@@ -254,7 +363,7 @@ SQLTransaction<T> DatabaseWorkerPool<T>::BeginTransaction()
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction)
+void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction, SQLPriority priority /*= SQLPriority::Normal*/)
 {
 #ifdef WARHEAD_DEBUG
     //! Only analyze transaction weaknesses in Debug mode.
@@ -273,7 +382,7 @@ void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction)
     }
 #endif // WARHEAD_DEBUG
 
-    Enqueue(new TransactionTask(transaction));
+    Enqueue(new TransactionTask(transaction), priority);
 }
 
 template <class T>
@@ -302,6 +411,15 @@ TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction
     return TransactionCallback(std::move(result));
 }
 
+template <class T>
+TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransactionOrdered(uint64 orderKey, SQLTransaction<T> transaction)
+{
+    TransactionWithResultTask* task = new TransactionWithResultTask(transaction);
+    TransactionFuture result = task->GetFuture();
+    EnqueueOrdered(orderKey, task);
+    return TransactionCallback(std::move(result));
+}
+
 template <class T>
 void DatabaseWorkerPool<T>::DirectCommitTransaction(SQLTransaction<T>& transaction)
 {
@@ -337,7 +455,10 @@ void DatabaseWorkerPool<T>::DirectCommitTransaction(SQLTransaction<T>& transacti
 template <class T>
 PreparedStatement<T>* DatabaseWorkerPool<T>::GetPreparedStatement(PreparedStatementIndex index)
 {
-    return new PreparedStatement<T>(index, _preparedStatementSize[index]);
+    if (PreparedStatementBase* stmt = _statementPool->Acquire(index))
+        return static_cast<PreparedStatement<T>*>(stmt);
+
+    return new PreparedStatement<T>(index, _preparedStatementSize[index], _statementPool.get());
 }
 
 template <class T>
@@ -365,13 +486,21 @@ void DatabaseWorkerPool<T>::KeepAlive()
         }
     }
 
-    //! Assuming all worker threads are free, every worker thread will receive 1 ping operation request
-    //! If one or more worker threads are busy, the ping operations will not be split evenly, but this doesn't matter
-    //! as the sole purpose is to prevent connections from idling.
+    //! Every worker thread receives 1 ping operation request pinned to its own connection,
+    //! so each connection is kept from idling even when another worker is free first.
     auto const count = _connections[IDX_ASYNC].size();
 
     for (uint8 i = 0; i < count; ++i)
-        Enqueue(new PingOperation);
+    {
+        SQLOperation* ping = new PingOperation;
+        ping->m_priority = SQLPriority::Bulk;
+        _queue->PushPinned(i, ping);
+    }
+
+    _elasticKeepAlive = true;
+
+    if (_nonBlocking)
+        _nonBlocking->KeepAlive();
 }
 
 template <class T>
@@ -385,14 +514,23 @@ uint32 DatabaseWorkerPool<T>::OpenConnections(InternalIndex type, uint8 numConne
             switch (type)
             {
             case IDX_ASYNC:
-                return std::make_unique<T>(_queue.get(), *_connectionInfo);
+                return std::make_unique<T>(_queue.get(), i, *_connectionInfo);
             case IDX_SYNCH:
                 return std::make_unique<T>(*_connectionInfo);
+            case IDX_NON_BLOCKING:
+            {
+                auto nonBlocking = std::make_unique<T>(*_connectionInfo);
+                nonBlocking->EnableNonBlocking();
+                return nonBlocking;
+            }
             default:
                 ABORT();
             }
         }();
 
+        connection->SetCircuitBreaker(_breaker.get());
+        connection->SetStatistics(_statistics.get());
+
         if (uint32 error = connection->Open())
         {
             // Failed to open a connection or invalid version, abort and cleanup
@@ -414,6 +552,118 @@ uint32 DatabaseWorkerPool<T>::OpenConnections(InternalIndex type, uint8 numConne
     return 0;
 }
 
+template <class T>
+void DatabaseWorkerPool<T>::SizerThread()
+{
+    std::unique_lock<std::mutex> lock(_sizerLock);
+
+    while (!_sizerCondition.wait_for(lock, ADAPTIVE_SAMPLE_INTERVAL, [this]() { return _sizerStop; }))
+    {
+        lock.unlock();
+        AdjustWorkers();
+
+        if (_elasticKeepAlive.exchange(false))
+            PingElasticConnections();
+
+        lock.lock();
+    }
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::AdjustWorkers()
+{
+    DatabaseQueueStats const load = _queue->CollectLoad();
+
+    // Nothing popped while work is queued means every worker is stuck on a long operation.
+    // Shrinking needs a much lower wait than growing, so the pool does not flap around the target.
+    bool const busy = load.AvgWait > _waitTarget || (load.Depth && !load.Executed);
+    bool const idle = !load.Depth && load.MaxWait < _waitTarget / 4;
+
+    _busySamples = busy ? _busySamples + 1 : 0;
+    _idleSamples = idle ? _idleSamples + 1 : 0;
+
+    if (_busySamples >= ADAPTIVE_GROW_SAMPLES && _queue->GetActiveLaneCount() < _queue->GetLaneCount())
+    {
+        _busySamples = 0;
+
+        // More connections do not help while the server is gone, they would only join the reconnect storm
+        if (!_breaker->IsOpen() && AddElasticConnection())
+            LOG_INFO("sql.driver", "DatabasePool '{}': added asynchronous connection, {} running. Queue {}, average wait {} us.",
+                GetDatabaseName(), _queue->GetActiveLaneCount(), load.Depth, load.AvgWait.count());
+    }
+    else if (_idleSamples * ADAPTIVE_SAMPLE_INTERVAL >= _idleTime && !_elasticConnections.empty())
+    {
+        _idleSamples = 0;
+        RemoveElasticConnection();
+
+        LOG_INFO("sql.driver", "DatabasePool '{}': removed idle asynchronous connection, {} running.",
+            GetDatabaseName(), _queue->GetActiveLaneCount());
+    }
+}
+
+template <class T>
+bool DatabaseWorkerPool<T>::AddElasticConnection()
+{
+    // The worker starts on an inactive lane and takes no work before the connection is ready
+    auto connection = std::make_unique<T>(_queue.get(), _queue->GetActiveLaneCount(), *_connectionInfo);
+    connection->SetCircuitBreaker(_breaker.get());
+    connection->SetStatistics(_statistics.get());
+
+    if (uint32 error = connection->Open())
+    {
+        LOG_WARN("sql.driver", "DatabasePool '{}': could not open an additional asynchronous connection, error {}.", GetDatabaseName(), error);
+        return false;
+    }
+
+    connection->LockIfReady();
+    bool const prepared = connection->PrepareStatements();
+    connection->Unlock();
+
+    if (!prepared)
+    {
+        LOG_WARN("sql.driver", "DatabasePool '{}': could not prepare statements on an additional asynchronous connection.", GetDatabaseName());
+        return false;
+    }
+
+    _elasticConnections.push_back(std::move(connection));
+    _queue->ActivateLane();
+    return true;
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::RemoveElasticConnection()
+{
+    // Stop feeding the lane first, the worker finishes its current operation and pings, shared leftovers are stolen by the others
+    _queue->DeactivateLane();
+    _elasticConnections.pop_back();
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::PingElasticConnections()
+{
+    for (std::size_t lane = _queue->GetFixedLaneCount(); lane < _queue->GetActiveLaneCount(); ++lane)
+    {
+        SQLOperation* ping = new PingOperation;
+        ping->m_priority = SQLPriority::Bulk;
+        _queue->PushPinned(lane, ping);
+    }
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::StopSizer()
+{
+    if (!_sizerThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_sizerLock);
+        _sizerStop = true;
+    }
+
+    _sizerCondition.notify_all();
+    _sizerThread.join();
+}
+
 template <class T>
 unsigned long DatabaseWorkerPool<T>::EscapeString(char* to, char const* from, unsigned long length)
 {
@@ -424,15 +674,85 @@ unsigned long DatabaseWorkerPool<T>::EscapeString(char* to, char const* from, un
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::Enqueue(SQLOperation* op)
+void DatabaseWorkerPool<T>::Enqueue(SQLOperation* op, SQLPriority priority /*= SQLPriority::Normal*/)
 {
+    if (!Admit(op, priority))
+        return;
+
+    op->m_priority = priority;
     _queue->Push(op);
 }
 
+template <class T>
+void DatabaseWorkerPool<T>::EnqueueOrdered(uint64 orderKey, SQLOperation* op, SQLPriority priority /*= SQLPriority::Normal*/)
+{
+    if (!Admit(op, priority))
+        return;
+
+    op->m_priority = priority;
+    _queue->PushPinned(_queue->GetLane(orderKey), op);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::EnqueuePrepared(PreparedStatementTask* task, SQLPriority priority)
+{
+    if (!_nonBlocking)
+    {
+        Enqueue(task, priority);
+        return;
+    }
+
+    if (Admit(task, priority))
+        _nonBlocking->Enqueue(task, priority);
+}
+
+template <class T>
+bool DatabaseWorkerPool<T>::Admit(SQLOperation* op, SQLPriority priority)
+{
+    //! Writes, transactions and batches wait for the reconnect, only queries with a consumer are shed
+    QueryCompletion* completion = op->GetQueryCompletion();
+    if (!completion || _breaker->Admit(priority, QueueSize()))
+        return true;
+
+    completion->SetRejected();
+    delete op;
+    return false;
+}
+
 template <class T>
 size_t DatabaseWorkerPool<T>::QueueSize() const
 {
-    return _queue->Size();
+    return _queue->Size() + (_nonBlocking ? _nonBlocking->QueueSize() : 0);
+}
+
+template <class T>
+std::vector<DatabaseStatementStats> DatabaseWorkerPool<T>::CollectStatementStats()
+{
+    return _statistics->CollectStatements();
+}
+
+template <class T>
+DatabaseStatementStats DatabaseWorkerPool<T>::CollectTotalStatementStats()
+{
+    return _statistics->CollectTotal();
+}
+
+template <class T>
+std::vector<DatabaseSlowStatement> DatabaseWorkerPool<T>::CollectSlowStatements()
+{
+    return _statistics->CollectSlowSamples();
+}
+
+template <class T>
+bool DatabaseWorkerPool<T>::IsAvailable() const
+{
+    return !_breaker->IsOpen();
+}
+
+template <class T>
+DatabaseQueueStats DatabaseWorkerPool<T>::CollectQueueStats(SQLPriority priority)
+{
+    return _queue->CollectStats(priority);
 }
 
 template <class T>
@@ -480,10 +800,69 @@ void DatabaseWorkerPool<T>::Execute(std::string_view sql)
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::Execute(PreparedStatement<T>* stmt)
+void DatabaseWorkerPool<T>::Execute(PreparedStatement<T>* stmt, SQLPriority priority /*= SQLPriority::Normal*/)
 {
     PreparedStatementTask* task = new PreparedStatementTask(stmt);
-    Enqueue(task);
+    EnqueuePrepared(task, priority);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::ExecuteOrdered(uint64 orderKey, PreparedStatement<T>* stmt)
+{
+    EnqueueOrdered(orderKey, new PreparedStatementTask(stmt));
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::ExecuteOrdered(uint64 orderKey, std::string_view sql)
+{
+    if (sql.empty())
+        return;
+
+    EnqueueOrdered(orderKey, new BasicStatementTask(sql));
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::ExecuteBatched(PreparedStatement<T>* stmt)
+{
+    SQLTransaction<T> full;
+
+    {
+        std::lock_guard<std::mutex> guard(_batchLock);
+
+        if (!_batch)
+        {
+            _batch = BeginTransaction();
+            _batchStart = std::chrono::steady_clock::now();
+        }
+
+        _batch->Append(stmt);
+
+        if (_batch->GetSize() >= _batchMaxSize)
+            full = std::move(_batch);
+    }
+
+    if (full)
+        EnqueueOrdered(WRITE_BEHIND_ORDER_KEY, new BatchedTransactionTask(std::move(full)), SQLPriority::Bulk);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::FlushBatched(bool force /*= false*/)
+{
+    SQLTransaction<T> batch;
+
+    {
+        std::lock_guard<std::mutex> guard(_batchLock);
+
+        if (!_batch)
+            return;
+
+        if (!force && std::chrono::steady_clock::now() - _batchStart < _batchInterval)
+            return;
+
+        batch = std::move(_batch);
+    }
+
+    EnqueueOrdered(WRITE_BEHIND_ORDER_KEY, new BatchedTransactionTask(std::move(batch)), SQLPriority::Bulk);
 }
 
 template <class T>
@@ -504,8 +883,8 @@ void DatabaseWorkerPool<T>::DirectExecute(PreparedStatement<T>* stmt)
     connection->Execute(stmt);
     connection->Unlock();
 
-    //! Delete proxy-class. Not needed anymore
-    delete stmt;
+    //! Release proxy-class. Not needed anymore
+    PreparedStatementBase::Free(stmt);
 }
 
 template <class T>
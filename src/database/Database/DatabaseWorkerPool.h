@@ -20,16 +20,31 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Define.h"
+#include "Duration.h"
 #include "StringFormat.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
-template <typename T>
-class ProducerConsumerQueue;
-
+class DatabaseCircuitBreaker;
+class DatabaseStatistics;
+class DatabaseWorkQueue;
+class MySQLNonBlockingDriver;
+class PreparedStatementPool;
+class PreparedStatementTask;
 class SQLOperation;
+struct DatabaseQueueStats;
+struct DatabaseSlowStatement;
+struct DatabaseStatementStats;
 struct MySQLConnectionInfo;
 
+//! Write-behind batches share one connection, so a later batch never overtakes an earlier one.
+//! ExecuteOrdered with this key runs after the batches enqueued before.
+constexpr uint64 WRITE_BEHIND_ORDER_KEY = 0;
+
 template <class T>
 class DatabaseWorkerPool
 {
@@ -38,6 +53,7 @@ private:
     {
         IDX_ASYNC,
         IDX_SYNCH,
+        IDX_NON_BLOCKING,
         IDX_SIZE
     };
 
@@ -46,7 +62,24 @@ public:
     DatabaseWorkerPool();
     ~DatabaseWorkerPool();
 
-    void SetConnectionInfo(std::string_view infoString, uint8 const asyncThreads, uint8 const synchThreads);
+    //! Up to maxAsyncThreads - asyncThreads more async connections are opened while the queue backs up, 0 keeps asyncThreads fixed.
+    void SetConnectionInfo(std::string_view infoString, uint8 const asyncThreads, uint8 const synchThreads, uint8 const reservedThreads = 0, uint8 const maxAsyncThreads = 0);
+    void SetWriteBehind(Milliseconds interval, uint32 maxBatchSize);
+
+    //! An async connection is added while operations wait longer than waitTarget, and removed again after idleTime without backlog.
+    void SetAdaptiveWorkers(Milliseconds waitTarget, Seconds idleTime);
+
+    //! While a connection reconnects, interactive operations fail at once and others are queued up to queueLimit.
+    //! Reconnects back off up to maxReconnectDelay, the process is terminated after reconnectAttempts (0 - never).
+    void SetCircuitBreaker(std::size_t queueLimit, Seconds maxReconnectDelay, uint32 reconnectAttempts);
+
+    //! Prepared statements executing longer than threshold are sampled with their parameters, the last maxSamples are kept.
+    void SetSlowQuery(Milliseconds threshold, uint32 maxSamples);
+
+    //! Runs Execute/AsyncQuery prepared statements on this many non-blocking connections driven by a single thread.
+    //! 0 keeps them on the worker threads. Ignored when the client library has no non-blocking API.
+    //! Statements start in enqueue order but run concurrently, a query may run before an earlier Execute.
+    void SetNonBlockingConnections(uint8 connections) { _nonBlockingConnections = connections; }
 
     uint32 Open();
     void Close();
@@ -80,7 +113,25 @@ public:
 
     //! Enqueues a one-way SQL operation in prepared statement format that will be executed asynchronously.
     //! Statement must be prepared with CONNECTION_ASYNC flag.
-    void Execute(PreparedStatement<T>* stmt);
+    void Execute(PreparedStatement<T>* stmt, SQLPriority priority = SQLPriority::Normal);
+
+    //! Enqueues a one-way SQL operation in prepared statement format on the connection picked by orderKey (e.g account id).
+    //! Statements sharing an orderKey are executed in the order they were enqueued, other statements may be run by any connection.
+    //! Reads are not ordered against it, wait for the write to complete (AsyncCommitTransactionOrdered) before reading its result back.
+    //! Statement must be prepared with CONNECTION_ASYNC flag.
+    void ExecuteOrdered(uint64 orderKey, PreparedStatement<T>* stmt);
+
+    //! Same as above for a one-way SQL operation in string format.
+    void ExecuteOrdered(uint64 orderKey, std::string_view sql);
+
+    //! Buffers a one-way prepared statement in the write-behind batch. All buffered statements are committed
+    //! together in one transaction once the batch is full or the flush interval elapsed, whichever comes first.
+    //! Batches are executed in order, but not ordered against plain Execute calls.
+    //! Statement must be prepared with CONNECTION_ASYNC flag.
+    void ExecuteBatched(PreparedStatement<T>* stmt);
+
+    //! Enqueues the write-behind batch if the flush interval elapsed, or unconditionally when forced.
+    void FlushBatched(bool force = false);
 
     /**
         Direct synchronous one-way statement methods.
@@ -129,18 +180,25 @@ public:
     //! Statement must be prepared with CONNECTION_SYNCH flag.
     PreparedQueryResult Query(PreparedStatement<T>* stmt);
 
+    //! Directly executes an SQL query in prepared format and hands its rows to callback in chunks of at most chunkRows rows,
+    //! without buffering the whole result. Blocks the calling thread until all rows were handled, returns the number of rows.
+    //! Every chunk reuses the same buffer, views into a chunk are only valid during the callback.
+    //! Callback must not run synchronous queries itself. Statement must be prepared with CONNECTION_SYNCH flag.
+    uint64 QueryStream(PreparedStatement<T>* stmt, PreparedResultChunkCallback const& callback, uint32 chunkRows = 1024);
+
     /**
         Asynchronous query (with resultset) methods.
     */
 
-    //! Enqueues a query in string format that will set the value of the QueryResultFuture return object as soon as the query is executed.
-    //! The return value is then processed in ProcessQueryCallback methods.
-    QueryCallback AsyncQuery(std::string_view sql);
+    //! Enqueues a query in string format that will complete the returned QueryCallback as soon as the query is executed.
+    //! The return value is then processed by QueryCallbackProcessor.
+    QueryCallback AsyncQuery(std::string_view sql, SQLPriority priority = SQLPriority::Normal);
 
-    //! Enqueues a query in prepared format that will set the value of the PreparedQueryResultFuture return object as soon as the query is executed.
-    //! The return value is then processed in ProcessQueryCallback methods.
+    //! Enqueues a query in prepared format that will complete the returned QueryCallback as soon as the query is executed.
+    //! The return value is then processed by QueryCallbackProcessor or co_await.
+    //! Use SQLPriority::Interactive for lookups a user is waiting for, they are run ahead of other classes.
     //! Statement must be prepared with CONNECTION_ASYNC flag.
-    QueryCallback AsyncQuery(PreparedStatement<T>* stmt);
+    QueryCallback AsyncQuery(PreparedStatement<T>* stmt, SQLPriority priority = SQLPriority::Normal);
 
     //! Enqueues a vector of SQL operations (can be both adhoc and prepared) that will set the value of the QueryResultHolderFuture
     //! return object as soon as the query is executed.
@@ -157,12 +215,15 @@ public:
 
     //! Enqueues a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
     //! were appended to the transaction will be respected during execution.
-    void CommitTransaction(SQLTransaction<T> transaction);
+    void CommitTransaction(SQLTransaction<T> transaction, SQLPriority priority = SQLPriority::Normal);
 
     //! Enqueues a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
     //! were appended to the transaction will be respected during execution.
     TransactionCallback AsyncCommitTransaction(SQLTransaction<T> transaction);
 
+    //! Same as AsyncCommitTransaction, on the connection picked by orderKey like ExecuteOrdered.
+    TransactionCallback AsyncCommitTransactionOrdered(uint64 orderKey, SQLTransaction<T> transaction);
+
     //! Directly executes a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
     //! were appended to the transaction will be respected during execution.
     void DirectCommitTransaction(SQLTransaction<T>& transaction);
@@ -182,7 +243,8 @@ public:
     typedef typename T::Statements PreparedStatementIndex;
 
     //! Automanaged (internally) pointer to a prepared statement object for usage in upper level code.
-    //! Pointer is deleted in this->DirectExecute(PreparedStatement*), this->Query(PreparedStatement*) or PreparedStatementTask::~PreparedStatementTask.
+    //! Pointer is released in this->DirectExecute(PreparedStatement*), this->Query(PreparedStatement*) or PreparedStatementTask::~PreparedStatementTask.
+    //! Released objects are recycled by the next call with the same index, never delete them in upper level code.
     //! This object is not tied to the prepared statement on the MySQL context yet until execution.
     PreparedStatement<T>* GetPreparedStatement(PreparedStatementIndex index);
 
@@ -201,12 +263,41 @@ public:
 
     [[nodiscard]] size_t QueueSize() const;
 
+    //! False while the circuit breaker is open, async queries may be rejected meanwhile (QueryCompletion::IsRejected)
+    [[nodiscard]] bool IsAvailable() const;
+
+    //! Queue depth and wait time of one priority class, wait counters are reset on every call.
+    DatabaseQueueStats CollectQueueStats(SQLPriority priority);
+
+    //! Queue wait, execution and decode latency per prepared statement, counters are reset on every call.
+    //! Only statements executed since the last call are returned.
+    std::vector<DatabaseStatementStats> CollectStatementStats();
+
+    //! Same latencies summed over all prepared statements of the pool.
+    DatabaseStatementStats CollectTotalStatementStats();
+
+    //! Slow executions sampled since the last call.
+    std::vector<DatabaseSlowStatement> CollectSlowStatements();
+
 private:
     uint32 OpenConnections(InternalIndex type, uint8 numConnections);
 
+    //! Adaptive async connections, only touched by the sizer thread until it is stopped
+    void SizerThread();
+    void AdjustWorkers();
+    bool AddElasticConnection();
+    void RemoveElasticConnection();
+    void PingElasticConnections();
+    void StopSizer();
+
     unsigned long EscapeString(char* to, char const* from, unsigned long length);
 
-    void Enqueue(SQLOperation* op);
+    void Enqueue(SQLOperation* op, SQLPriority priority = SQLPriority::Normal);
+    void EnqueueOrdered(uint64 orderKey, SQLOperation* op, SQLPriority priority = SQLPriority::Normal);
+    void EnqueuePrepared(PreparedStatementTask* task, SQLPriority priority);
+
+    //! Deletes a query when the circuit breaker rejects it, other operations are always admitted
+    bool Admit(SQLOperation* op, SQLPriority priority);
 
     //! Gets a free connection in the synchronous connection pool.
     //! Caller MUST call t->Unlock() after touching the MySQL context to prevent deadlocks.
@@ -214,13 +305,45 @@ private:
 
     [[nodiscard]] std::string_view GetDatabaseName() const;
 
-    //! Queue shared by async worker threads.
-    std::unique_ptr<ProducerConsumerQueue<SQLOperation*>> _queue;
+    //! Recycled statement objects, destroyed last since queued tasks still release into it
+    std::unique_ptr<PreparedStatementPool> _statementPool;
+
+    //! Outage state and latency counters of all connections, they keep a pointer to them
+    std::unique_ptr<DatabaseCircuitBreaker> _breaker;
+    std::unique_ptr<DatabaseStatistics> _statistics;
+
+    //! Per-connection queues of the async worker threads, created with the connection info.
+    std::unique_ptr<DatabaseWorkQueue> _queue;
     std::array<std::vector<std::unique_ptr<T>>, IDX_SIZE> _connections;
     std::unique_ptr<MySQLConnectionInfo> _connectionInfo;
     std::vector<uint8> _preparedStatementSize;
     uint8 _async_threads, _synch_threads;
 
+    //! Async connections above _async_threads, opened and closed by the sizer thread
+    std::vector<std::unique_ptr<T>> _elasticConnections;
+    Milliseconds _waitTarget{ 50ms };
+    Seconds _idleTime{ 60s };
+    uint32 _busySamples{ 0 };
+    uint32 _idleSamples{ 0 };
+    std::thread _sizerThread;
+    std::mutex _sizerLock;
+    std::condition_variable _sizerCondition;
+    bool _sizerStop{ false };
+
+    //! Set by KeepAlive, elastic lanes are pinged by the sizer thread so no ping lands on a lane being removed
+    std::atomic<bool> _elasticKeepAlive{ false };
+
+    //! Optional single thread backend for prepared Execute/AsyncQuery
+    std::unique_ptr<MySQLNonBlockingDriver> _nonBlocking;
+    uint8 _nonBlockingConnections{ 0 };
+
+    //! Write-behind batch
+    std::mutex _batchLock;
+    SQLTransaction<T> _batch;
+    TimePoint _batchStart;
+    Milliseconds _batchInterval{ 1s };
+    uint32 _batchMaxSize{ 100 };
+
 #ifdef WARHEAD_DEBUG
     static inline thread_local bool _warnSyncQueries = false;
 #endif
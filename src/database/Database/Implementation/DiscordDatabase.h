@@ -30,12 +30,13 @@ enum DiscordDatabaseStatements : uint32
 
     DISCORD_SEL_ACCOUNT_INFO_BY_NAME,
     DISCORD_INS_ACCOUNT,
-    DISCORD_SEL_IP_INFO,
     DISCORD_SEL_ACCOUNT_ID_BY_USERNAME,
     DISCORD_SEL_ACCOUNTS,
     DISCORD_UPD_LOGON,
 
     // Ban manager
+    DISCORD_SEL_ACCOUNT_BANS,
+    DISCORD_SEL_IP_BANS,
     DISCORD_DEL_BAN_ACCOUNT,
     DISCORD_DEL_BAN_IP,
     DISCORD_INS_ACCOUNT_BAN,
@@ -43,7 +44,13 @@ enum DiscordDatabaseStatements : uint32
     DISCORD_UPD_ACCOUNT_BAN_EXPIRED,
     DISCORD_UPD_IP_BAN_EXPIRED,
 
+    DISCORD_SEL_CLIENTS,
     DISCORD_INS_CLIENT,
+    DISCORD_DEL_CLIENT,
+
+    // Event templates
+    DISCORD_SEL_EVENT_TEMPLATES,
+    DISCORD_SEL_EVENT_TEMPLATE_FIELDS,
 
     MAX_DISCORD_DATABASE_STATEMENTS
 };
@@ -55,7 +62,7 @@ public:
 
     //- Constructors for sync and async connections
     DiscordDatabaseConnection(MySQLConnectionInfo& connInfo);
-    DiscordDatabaseConnection(ProducerConsumerQueue<SQLOperation*>* q, MySQLConnectionInfo& connInfo);
+    DiscordDatabaseConnection(DatabaseWorkQueue* q, std::size_t lane, MySQLConnectionInfo& connInfo);
     ~DiscordDatabaseConnection() override;
 
     //- Loads database type specific prepared statements
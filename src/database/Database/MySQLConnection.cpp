@@ -16,6 +16,8 @@
  */
 
 #include "MySQLConnection.h"
+#include "DatabaseCircuitBreaker.h"
+#include "DatabaseStatistics.h"
 #include "DatabaseWorker.h"
 #include "Log.h"
 #include "MySQLHacks.h"
@@ -53,19 +55,25 @@ MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo) :
     m_reconnecting(false),
     m_prepareError(false),
     m_queue(nullptr),
+    m_breaker(nullptr),
+    m_statistics(nullptr),
     m_Mysql(nullptr),
     m_connectionInfo(connInfo),
-    m_connectionFlags(CONNECTION_SYNCH) { }
+    m_connectionFlags(CONNECTION_SYNCH),
+    m_nonBlocking(false) { }
 
-MySQLConnection::MySQLConnection(ProducerConsumerQueue<SQLOperation*>* queue, MySQLConnectionInfo& connInfo) :
+MySQLConnection::MySQLConnection(DatabaseWorkQueue* queue, std::size_t lane, MySQLConnectionInfo& connInfo) :
     m_reconnecting(false),
     m_prepareError(false),
     m_queue(queue),
+    m_breaker(nullptr),
+    m_statistics(nullptr),
     m_Mysql(nullptr),
     m_connectionInfo(connInfo),
-    m_connectionFlags(CONNECTION_ASYNC)
+    m_connectionFlags(CONNECTION_ASYNC),
+    m_nonBlocking(false)
 {
-    m_worker = std::make_unique<DatabaseWorker>(m_queue, this);
+    m_worker = std::make_unique<DatabaseWorker>(m_queue, lane, this);
 }
 
 MySQLConnection::~MySQLConnection()
@@ -150,6 +158,11 @@ uint32 MySQLConnection::Open()
 #endif
     }
 
+#ifdef MARIADB_VERSION_ID
+    if (m_nonBlocking)
+        mysql_options(mysqlInit, MYSQL_OPT_NONBLOCK, 0);
+#endif
+
     m_Mysql = reinterpret_cast<MySQLHandle*>(mysql_real_connect(mysqlInit, m_connectionInfo.host.c_str(), m_connectionInfo.user.c_str(),
         m_connectionInfo.password.c_str(), m_connectionInfo.database.c_str(), port, unix_socket, 0));
 
@@ -178,6 +191,14 @@ uint32 MySQLConnection::Open()
     }
 }
 
+void MySQLConnection::EnableNonBlocking()
+{
+    ASSERT(!m_Mysql && !m_worker);
+
+    m_connectionFlags = CONNECTION_ASYNC;
+    m_nonBlocking = true;
+}
+
 bool MySQLConnection::PrepareStatements()
 {
     DoPrepareStatements();
@@ -221,13 +242,13 @@ bool MySQLConnection::Execute(PreparedStatementBase* stmt)
     MySQLPreparedStatement* m_mStmt = GetPreparedStatement(index);
     ASSERT(m_mStmt); // Can only be null if preparation failed, server side error or bad query
 
+    StopWatch sw;
+
     m_mStmt->BindParameters(stmt);
 
     MYSQL_STMT* msql_STMT = m_mStmt->GetSTMT();
     MYSQL_BIND* msql_BIND = m_mStmt->GetBind();
 
-    StopWatch sw;
-
     if (mysql_stmt_bind_param(msql_STMT, msql_BIND))
     {
         uint32 lErrno = mysql_errno(m_Mysql);
@@ -237,6 +258,7 @@ bool MySQLConnection::Execute(PreparedStatementBase* stmt)
             return Execute(stmt);       // Try again
 
         m_mStmt->ClearParameters();
+        RecordError(index);
         return false;
     }
 
@@ -249,10 +271,12 @@ bool MySQLConnection::Execute(PreparedStatementBase* stmt)
             return Execute(stmt);       // Try again
 
         m_mStmt->ClearParameters();
+        RecordError(index);
         return false;
     }
 
     LOG_DEBUG("sql.sql", "[{}] SQL(p): {}", sw, m_mStmt->getQueryString());
+    RecordExecute(m_mStmt, index, sw.Elapsed());
 
     m_mStmt->ClearParameters();
     return true;
@@ -268,14 +292,14 @@ bool MySQLConnection::_Query(PreparedStatementBase* stmt, MySQLPreparedStatement
     MySQLPreparedStatement* m_mStmt = GetPreparedStatement(index);
     ASSERT(m_mStmt);            // Can only be null if preparation failed, server side error or bad query
 
+    StopWatch sw;
+
     m_mStmt->BindParameters(stmt);
     *mysqlStmt = m_mStmt;
 
     MYSQL_STMT* msql_STMT = m_mStmt->GetSTMT();
     MYSQL_BIND* msql_BIND = m_mStmt->GetBind();
 
-    StopWatch sw;
-
     if (mysql_stmt_bind_param(msql_STMT, msql_BIND))
     {
         uint32 lErrno = mysql_errno(m_Mysql);
@@ -285,6 +309,7 @@ bool MySQLConnection::_Query(PreparedStatementBase* stmt, MySQLPreparedStatement
             return _Query(stmt, mysqlStmt, pResult, pRowCount, pFieldCount);       // Try again
 
         m_mStmt->ClearParameters();
+        RecordError(index);
         return false;
     }
 
@@ -297,10 +322,12 @@ bool MySQLConnection::_Query(PreparedStatementBase* stmt, MySQLPreparedStatement
             return _Query(stmt, mysqlStmt, pResult, pRowCount, pFieldCount);      // Try again
 
         m_mStmt->ClearParameters();
+        RecordError(index);
         return false;
     }
 
     LOG_DEBUG("sql.sql", "[{}] SQL(p): {}", sw, m_mStmt->getQueryString());
+    RecordExecute(m_mStmt, index, sw.Elapsed());
 
     m_mStmt->ClearParameters();
 
@@ -548,10 +575,64 @@ PreparedResultSet* MySQLConnection::Query(PreparedStatementBase* stmt)
         mysql_next_result(m_Mysql);
     }
 
-    return new PreparedResultSet(mysqlStmt->GetSTMT(), result, rowCount, fieldCount);
+    StopWatch sw;
+    PreparedResultSet* resultSet = new PreparedResultSet(mysqlStmt->GetSTMT(), result, rowCount, fieldCount);
+
+    if (m_statistics)
+        m_statistics->Add(stmt->GetIndex(), SQLStage::Decode, sw.Elapsed());
+
+    return resultSet;
+}
+
+uint64 MySQLConnection::QueryStream(PreparedStatementBase* stmt, uint32 chunkRows, PreparedResultChunkCallback const& callback)
+{
+    MySQLPreparedStatement* mysqlStmt = nullptr;
+    MySQLResult* result = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(stmt, &mysqlStmt, &result, &rowCount, &fieldCount))
+        return 0;
+
+    uint64 totalRows = 0;
+
+    {
+        //- Next chunk is only read from the socket once the callback handled the previous one
+        auto stream = PreparedResultSet::OpenStream(mysqlStmt->GetSTMT(), result, fieldCount, chunkRows);
+
+        while (stream->NextChunk())
+        {
+            callback(*stream);
+            totalRows += stream->GetRowCount();
+        }
+    }
+
+    if (mysql_more_results(m_Mysql))
+    {
+        mysql_next_result(m_Mysql);
+    }
+
+    return totalRows;
 }
 
-bool MySQLConnection::_HandleMySQLErrno(uint32 errNo, uint8 attempts /*= 5*/)
+void MySQLConnection::RecordExecute(MySQLPreparedStatement* stmt, uint32 index, Microseconds elapsed)
+{
+    if (!m_statistics)
+        return;
+
+    m_statistics->Add(index, SQLStage::Execute, elapsed);
+
+    if (m_statistics->IsSlow(elapsed))
+        m_statistics->AddSlowSample(index, elapsed, stmt->getQueryString());
+}
+
+void MySQLConnection::RecordError(uint32 index)
+{
+    if (m_statistics)
+        m_statistics->AddError(index);
+}
+
+bool MySQLConnection::_HandleMySQLErrno(uint32 errNo)
 {
     switch (errNo)
     {
@@ -570,45 +651,53 @@ bool MySQLConnection::_HandleMySQLErrno(uint32 errNo, uint8 attempts /*= 5*/)
         }
         case CR_CONN_HOST_ERROR:
         {
-            LOG_INFO("sql.sql", "Attempting to reconnect to the MySQL server...");
-
             m_reconnecting = true;
 
-            uint32 const lErrno = Open();
-            if (!lErrno)
+            // Callers of the pool are not blocked by this reconnect, the breaker limits what they can queue meanwhile
+            if (m_breaker)
+                m_breaker->Trip();
+
+            uint32 const attempts = m_breaker ? m_breaker->GetReconnectAttempts() : 5;
+
+            for (uint32 attempt = 1;; ++attempt)
             {
-                // Don't remove 'this' pointer unless you want to skip loading all prepared statements...
-                if (!this->PrepareStatements())
+                LOG_INFO("sql.sql", "Attempting to reconnect to the MySQL server...");
+
+                if (!Open())
                 {
-                    LOG_CRIT("sql.sql", "Could not re-prepare statements!");
-                    std::this_thread::sleep_for(10s);
-                    std::abort();
-                }
+                    // Don't remove 'this' pointer unless you want to skip loading all prepared statements...
+                    if (!this->PrepareStatements())
+                    {
+                        LOG_CRIT("sql.sql", "Could not re-prepare statements!");
+                        std::this_thread::sleep_for(10s);
+                        std::abort();
+                    }
 
-                LOG_INFO("sql.sql", "Successfully reconnected to {} @{}:{} ({}).",
-                    m_connectionInfo.database, m_connectionInfo.host, m_connectionInfo.port_or_socket,
-                        (m_connectionFlags & CONNECTION_ASYNC) ? "asynchronous" : "synchronous");
+                    LOG_INFO("sql.sql", "Successfully reconnected to {} @{}:{} ({}).",
+                        m_connectionInfo.database, m_connectionInfo.host, m_connectionInfo.port_or_socket,
+                            (m_connectionFlags & CONNECTION_ASYNC) ? "asynchronous" : "synchronous");
 
-                m_reconnecting = false;
-                return true;
-            }
+                    m_reconnecting = false;
 
-            if ((--attempts) == 0)
-            {
-                // Shut down the server when the mysql server isn't
-                // reachable for some time
-                LOG_CRIT("sql.sql", "Failed to reconnect to the MySQL server, terminating the server to prevent data corruption!");
+                    if (m_breaker)
+                        m_breaker->Reset();
 
-                // We could also initiate a shutdown through using std::raise(SIGTERM)
-                std::this_thread::sleep_for(10s);
-                std::abort();
-            }
-            else
-            {
-                // It's possible this attempted reconnect throws 2006 at us.
-                // To prevent crazy recursive calls, sleep here.
-                std::this_thread::sleep_for(3s); // Sleep 3 seconds
-                return _HandleMySQLErrno(lErrno, attempts); // Call self (recursive)
+                    return true;
+                }
+
+                if (attempts && attempt >= attempts)
+                {
+                    // Shut down the server when the mysql server isn't
+                    // reachable for some time
+                    LOG_CRIT("sql.sql", "Failed to reconnect to the MySQL server, terminating the server to prevent data corruption!");
+
+                    // We could also initiate a shutdown through using std::raise(SIGTERM)
+                    std::this_thread::sleep_for(10s);
+                    std::abort();
+                }
+
+                // It's possible this attempted reconnect throws 2006 at us, back off before the next one
+                std::this_thread::sleep_for(m_breaker ? m_breaker->GetReconnectDelay(attempt) : 3s);
             }
         }
 
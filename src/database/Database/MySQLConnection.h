@@ -20,16 +20,17 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Define.h"
+#include "Duration.h"
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
-template <typename T>
-class ProducerConsumerQueue;
-
+class DatabaseCircuitBreaker;
+class DatabaseStatistics;
 class DatabaseWorker;
+class DatabaseWorkQueue;
 class MySQLPreparedStatement;
 class SQLOperation;
 
@@ -58,10 +59,11 @@ template <class T>
 friend class DatabaseWorkerPool;
 
 friend class PingOperation;
+friend class MySQLNonBlockingDriver;
 
 public:
     MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
-    MySQLConnection(ProducerConsumerQueue<SQLOperation*>* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
+    MySQLConnection(DatabaseWorkQueue* queue, std::size_t lane, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
     virtual ~MySQLConnection();
 
     virtual uint32 Open();
@@ -69,10 +71,22 @@ public:
 
     bool PrepareStatements();
 
+    //! Connection is driven by MySQLNonBlockingDriver: prepares async statements, has no worker thread.
+    //! Must be called before Open().
+    void EnableNonBlocking();
+
+    //! Lost server trips the breaker of the pool, a reconnect resets it. Must be called before Open().
+    void SetCircuitBreaker(DatabaseCircuitBreaker* breaker) { m_breaker = breaker; }
+
+    //! Latency counters of the pool, prepared statements are recorded in them. Must be called before Open().
+    void SetStatistics(DatabaseStatistics* statistics) { m_statistics = statistics; }
+    [[nodiscard]] DatabaseStatistics* GetStatistics() const { return m_statistics; }
+
     bool Execute(std::string_view sql);
     bool Execute(PreparedStatementBase* stmt);
     ResultSet* Query(std::string_view sql);
     PreparedResultSet* Query(PreparedStatementBase* stmt);
+    uint64 QueryStream(PreparedStatementBase* stmt, uint32 chunkRows, PreparedResultChunkCallback const& callback);
     bool _Query(std::string_view sql, MySQLResult** pResult, MySQLField** pFields, uint64* pRowCount, uint32* pFieldCount);
     bool _Query(PreparedStatementBase* stmt, MySQLPreparedStatement** mysqlStmt, MySQLResult** pResult, uint64* pRowCount, uint32* pFieldCount);
 
@@ -106,13 +120,19 @@ protected:
     bool m_prepareError;  //! Was there any error while preparing statements?
 
 private:
-    bool _HandleMySQLErrno(uint32 errNo, uint8 attempts = 5);
+    bool _HandleMySQLErrno(uint32 errNo);
+
+    void RecordExecute(MySQLPreparedStatement* stmt, uint32 index, Microseconds elapsed);
+    void RecordError(uint32 index);
 
-    ProducerConsumerQueue<SQLOperation*>* m_queue;      //! Queue shared with other asynchronous connections.
+    DatabaseWorkQueue* m_queue;                         //! Queue shared with other asynchronous connections.
+    DatabaseCircuitBreaker* m_breaker;                  //! Outage state shared with the other connections of the pool.
+    DatabaseStatistics* m_statistics;                   //! Statement latency counters of the pool.
     std::unique_ptr<DatabaseWorker> m_worker;           //! Core worker task.
     MySQLHandle* m_Mysql;                               //! MySQL Handle.
     MySQLConnectionInfo& m_connectionInfo;              //! Connection info (used for logging)
     ConnectionFlags m_connectionFlags;                  //! Connection flags (for preparing relevant statements)
+    bool m_nonBlocking;                                 //! Opened with the client's non-blocking API enabled
     std::mutex m_Mutex;
 
     MySQLConnection(MySQLConnection const& right) = delete;
@@ -0,0 +1,375 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MySQLNonBlockingDriver.h"
+#include "DatabaseStatistics.h"
+#include "Errors.h"
+#include "IoContext.h"
+#include "Log.h"
+#include "MySQLConnection.h"
+#include "MySQLHacks.h"
+#include "MySQLPreparedStatement.h"
+#include "PreparedStatement.h"
+#include "QueryCompletion.h"
+#include "QueryResult.h"
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+// Only MariaDB's client library has the non-blocking API, and we wait on its POSIX socket
+#if defined(MARIADB_VERSION_ID) && !defined(_WIN32)
+#define WARHEAD_MYSQL_NON_BLOCKING
+#include <boost/asio/posix/stream_descriptor.hpp>
+#endif
+
+struct MySQLNonBlockingDriver::Context
+{
+    Warhead::Asio::IoContext IoContext;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> WorkGuard{ IoContext.get_executor() };
+};
+
+#ifdef WARHEAD_MYSQL_NON_BLOCKING
+
+enum class SlotStage : uint8
+{
+    Execute,
+    StoreResult
+};
+
+struct MySQLNonBlockingDriver::Slot
+{
+    Slot(boost::asio::io_context& ioContext, MySQLConnection* connection) :
+        Connection(connection), Socket(ioContext), Timer(ioContext) { }
+
+    MySQLConnection* Connection;
+    boost::asio::posix::stream_descriptor Socket;
+    boost::asio::steady_timer Timer;
+
+    PreparedStatementTask* Task{ nullptr };
+    MySQLPreparedStatement* Statement{ nullptr };
+    SlotStage Stage{ SlotStage::Execute };
+    TimePoint StageStart;
+
+    // Bumped on every resume, so the losing socket or timer handler is ignored
+    uint32 WaitId{ 0 };
+};
+
+MySQLNonBlockingDriver::MySQLNonBlockingDriver() :
+    _context(std::make_unique<Context>()) { }
+
+MySQLNonBlockingDriver::~MySQLNonBlockingDriver()
+{
+    Stop();
+}
+
+bool MySQLNonBlockingDriver::IsSupported()
+{
+    return true;
+}
+
+void MySQLNonBlockingDriver::AddConnection(MySQLConnection* connection)
+{
+    ASSERT(connection->m_nonBlocking);
+    ASSERT(!_thread.joinable());
+
+    _slots.emplace_back(std::make_unique<Slot>(_context->IoContext, connection));
+}
+
+void MySQLNonBlockingDriver::Start()
+{
+    for (auto& slot : _slots)
+        slot->Socket.assign(mysql_get_socket(slot->Connection->m_Mysql));
+
+    _thread = std::thread([this]() { _context->IoContext.run(); });
+}
+
+void MySQLNonBlockingDriver::Stop()
+{
+    if (!_thread.joinable())
+        return;
+
+    // Queued statements are finished too, posted after everything enqueued before
+    Warhead::Asio::post(_context->IoContext, [this]()
+    {
+        _stopping = true;
+        StopIfIdle();
+    });
+
+    _thread.join();
+
+    // The socket belongs to the MySQL handle, it is closed by mysql_close
+    for (auto& slot : _slots)
+        slot->Socket.release();
+
+    // Nothing is left unless the driver thread stopped early, completions are finished with an empty result
+    for (auto& pending : _pending)
+    {
+        for (PreparedStatementTask* task : pending)
+            delete task;
+
+        pending.clear();
+    }
+
+    _queueSize = 0;
+}
+
+void MySQLNonBlockingDriver::Enqueue(PreparedStatementTask* task, SQLPriority priority)
+{
+    task->m_priority = priority;
+    task->m_queueTime = std::chrono::steady_clock::now();
+    ++_queueSize;
+
+    Warhead::Asio::post(_context->IoContext, [this, task]() { Dispatch(task); });
+}
+
+void MySQLNonBlockingDriver::KeepAlive()
+{
+    Warhead::Asio::post(_context->IoContext, [this]()
+    {
+        // Busy connections are not idling anyway
+        for (auto& slot : _slots)
+            if (!slot->Task)
+                slot->Connection->Ping();
+    });
+}
+
+void MySQLNonBlockingDriver::Dispatch(PreparedStatementTask* task)
+{
+    if (_stopping)
+    {
+        delete task;
+        --_queueSize;
+        return;
+    }
+
+    for (auto& slot : _slots)
+    {
+        if (!slot->Task)
+        {
+            Begin(*slot, task);
+            return;
+        }
+    }
+
+    _pending[static_cast<std::size_t>(task->m_priority)].push_back(task);
+}
+
+void MySQLNonBlockingDriver::Begin(Slot& slot, PreparedStatementTask* task, bool retry /*= false*/)
+{
+    DatabaseStatistics* statistics = slot.Connection->GetStatistics();
+
+    // A retry after reconnect already waited in the queue
+    if (statistics && !retry)
+        statistics->Add(task->m_stmt->GetIndex(), SQLStage::QueueWait, std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - task->m_queueTime));
+
+    slot.Task = task;
+    slot.Stage = SlotStage::Execute;
+    slot.StageStart = std::chrono::steady_clock::now();
+    slot.Statement = slot.Connection->GetPreparedStatement(task->m_stmt->GetIndex());
+    ASSERT(slot.Statement); // Can only be null if preparation failed, server side error or bad query
+
+    slot.Statement->BindParameters(task->m_stmt);
+
+    if (mysql_stmt_bind_param(slot.Statement->GetSTMT(), slot.Statement->GetBind()))
+    {
+        Fail(slot);
+        return;
+    }
+
+    int error = 0;
+    int status = mysql_stmt_execute_start(&error, slot.Statement->GetSTMT());
+    Continue(slot, status, error);
+}
+
+void MySQLNonBlockingDriver::Continue(Slot& slot, int status, int error)
+{
+    if (status)
+    {
+        Wait(slot, status);
+        return;
+    }
+
+    if (error)
+    {
+        Fail(slot);
+        return;
+    }
+
+    MySQLStmt* stmt = slot.Statement->GetSTMT();
+
+    uint32 const index = slot.Task->m_stmt->GetIndex();
+    Microseconds const elapsed = std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - slot.StageStart);
+
+    if (slot.Stage == SlotStage::Execute)
+    {
+        slot.Connection->RecordExecute(slot.Statement, index, elapsed);
+        slot.Statement->ClearParameters();
+
+        if (!slot.Task->m_has_result)
+        {
+            Finish(slot);
+            return;
+        }
+
+        slot.Stage = SlotStage::StoreResult;
+        slot.StageStart = std::chrono::steady_clock::now();
+        status = mysql_stmt_store_result_start(&error, stmt);
+        Continue(slot, status, error);
+        return;
+    }
+
+    MySQLResult* metadata = reinterpret_cast<MySQLResult*>(mysql_stmt_result_metadata(stmt));
+    uint64 rowCount = mysql_stmt_num_rows(stmt);
+    uint32 fieldCount = mysql_stmt_field_count(stmt);
+
+    // Same as MySQLConnection::Query, only happens for procedures
+    if (mysql_more_results(slot.Connection->m_Mysql))
+        mysql_next_result(slot.Connection->m_Mysql);
+
+    PreparedResultSet* result = new PreparedResultSet(stmt, metadata, rowCount, fieldCount, true);
+
+    if (DatabaseStatistics* statistics = slot.Connection->GetStatistics())
+        statistics->Add(index, SQLStage::Decode, std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - slot.StageStart));
+    if (!result->GetRowCount())
+    {
+        delete result;
+        result = nullptr;
+    }
+
+    slot.Task->m_completion->SetResult(PreparedQueryResult(result));
+    Finish(slot);
+}
+
+void MySQLNonBlockingDriver::Wait(Slot& slot, int status)
+{
+    uint32 const waitId = ++slot.WaitId;
+
+    auto resume = [this, &slot, waitId](boost::system::error_code const& error, int ready)
+    {
+        if (error || slot.WaitId != waitId)
+            return;
+
+        ++slot.WaitId;
+
+        boost::system::error_code ignored;
+        slot.Socket.cancel(ignored);
+        slot.Timer.cancel();
+
+        int result = 0;
+        int next = slot.Stage == SlotStage::Execute ?
+            mysql_stmt_execute_cont(&result, slot.Statement->GetSTMT(), ready) :
+            mysql_stmt_store_result_cont(&result, slot.Statement->GetSTMT(), ready);
+
+        Continue(slot, next, result);
+    };
+
+    if (status & MYSQL_WAIT_READ)
+        slot.Socket.async_wait(boost::asio::posix::stream_descriptor::wait_read, [resume](boost::system::error_code const& error) { resume(error, MYSQL_WAIT_READ); });
+
+    if (status & MYSQL_WAIT_WRITE)
+        slot.Socket.async_wait(boost::asio::posix::stream_descriptor::wait_write, [resume](boost::system::error_code const& error) { resume(error, MYSQL_WAIT_WRITE); });
+
+    if (status & MYSQL_WAIT_EXCEPT)
+        slot.Socket.async_wait(boost::asio::posix::stream_descriptor::wait_error, [resume](boost::system::error_code const& error) { resume(error, MYSQL_WAIT_EXCEPT); });
+
+    if (status & MYSQL_WAIT_TIMEOUT)
+    {
+        slot.Timer.expires_after(Milliseconds(mysql_get_timeout_value_ms(slot.Connection->m_Mysql)));
+        slot.Timer.async_wait([resume](boost::system::error_code const& error) { resume(error, MYSQL_WAIT_TIMEOUT); });
+    }
+}
+
+void MySQLNonBlockingDriver::Fail(Slot& slot)
+{
+    MySQLConnection* connection = slot.Connection;
+    uint32 lErrno = mysql_errno(connection->m_Mysql);
+
+    LOG_ERROR("sql.sql", "SQL(p): {}\n [ERROR]: [{}] {}", slot.Statement->getQueryString(), lErrno, mysql_stmt_error(slot.Statement->GetSTMT()));
+
+    slot.Statement->ClearParameters();
+
+    // Reconnects block this thread, same as a worker thread would be blocked
+    if (connection->_HandleMySQLErrno(lErrno))
+    {
+        slot.Socket.release();
+        slot.Socket.assign(mysql_get_socket(connection->m_Mysql));
+
+        Begin(slot, slot.Task, true); // Try again
+        return;
+    }
+
+    connection->RecordError(slot.Task->m_stmt->GetIndex());
+
+    if (slot.Task->m_has_result)
+        slot.Task->m_completion->SetResult(PreparedQueryResult(nullptr));
+
+    Finish(slot);
+}
+
+void MySQLNonBlockingDriver::Finish(Slot& slot)
+{
+    delete slot.Task;
+    slot.Task = nullptr;
+    slot.Statement = nullptr;
+    --_queueSize;
+
+    for (auto& pending : _pending)
+    {
+        if (pending.empty())
+            continue;
+
+        PreparedStatementTask* task = pending.front();
+        pending.pop_front();
+        Begin(slot, task);
+        return;
+    }
+
+    if (_stopping)
+        StopIfIdle();
+}
+
+void MySQLNonBlockingDriver::StopIfIdle()
+{
+    for (auto& slot : _slots)
+        if (slot->Task)
+            return;
+
+    // Pending statements always wait for a busy slot
+    _context->WorkGuard.reset();
+}
+
+#else
+
+struct MySQLNonBlockingDriver::Slot { };
+
+MySQLNonBlockingDriver::MySQLNonBlockingDriver() :
+    _context(std::make_unique<Context>()) { }
+
+MySQLNonBlockingDriver::~MySQLNonBlockingDriver() = default;
+
+bool MySQLNonBlockingDriver::IsSupported()
+{
+    return false;
+}
+
+void MySQLNonBlockingDriver::AddConnection(MySQLConnection* /*connection*/) { ABORT(); }
+void MySQLNonBlockingDriver::Start() { ABORT(); }
+void MySQLNonBlockingDriver::Stop() { }
+void MySQLNonBlockingDriver::StopIfIdle() { }
+void MySQLNonBlockingDriver::Enqueue(PreparedStatementTask* /*task*/, SQLPriority /*priority*/) { ABORT(); }
+void MySQLNonBlockingDriver::KeepAlive() { }
+
+#endif
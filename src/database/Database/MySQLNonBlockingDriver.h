@@ -0,0 +1,81 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MYSQL_NON_BLOCKING_DRIVER_H
+#define _MYSQL_NON_BLOCKING_DRIVER_H
+
+#include "DatabaseEnvFwd.h"
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class MySQLConnection;
+class PreparedStatementTask;
+
+// Runs prepared statements on non-blocking connections from a single io_context thread.
+// A statement waiting for the server only holds its connection, not a thread.
+// Statements start in FIFO order per priority, but with several connections they finish in any order.
+// Needs the MariaDB client API (mysql_stmt_execute_start/_cont), see IsSupported().
+class WH_DATABASE_API MySQLNonBlockingDriver
+{
+public:
+    MySQLNonBlockingDriver();
+    ~MySQLNonBlockingDriver();
+
+    [[nodiscard]] static bool IsSupported();
+
+    //! Connections must be opened with EnableNonBlocking(), before Start()
+    void AddConnection(MySQLConnection* connection);
+    void Start();
+
+    //! Returns once every enqueued statement is finished
+    void Stop();
+
+    void Enqueue(PreparedStatementTask* task, SQLPriority priority);
+    void KeepAlive();
+
+    [[nodiscard]] std::size_t QueueSize() const { return _queueSize; }
+
+private:
+    struct Context;
+    struct Slot;
+
+    // Only called on the driver thread
+    void Dispatch(PreparedStatementTask* task);
+    void Begin(Slot& slot, PreparedStatementTask* task, bool retry = false);
+    void Continue(Slot& slot, int status, int error);
+    void Wait(Slot& slot, int status);
+    void Fail(Slot& slot);
+    void Finish(Slot& slot);
+    void StopIfIdle();
+
+    std::unique_ptr<Context> _context;
+    std::thread _thread;
+    std::vector<std::unique_ptr<Slot>> _slots;
+    std::array<std::deque<PreparedStatementTask*>, MAX_SQL_PRIORITY> _pending;
+    std::atomic<std::size_t> _queueSize{ 0 };
+    std::atomic<bool> _stopping{ false };
+
+    MySQLNonBlockingDriver(MySQLNonBlockingDriver const&) = delete;
+    MySQLNonBlockingDriver& operator=(MySQLNonBlockingDriver const&) = delete;
+};
+
+#endif // _MYSQL_NON_BLOCKING_DRIVER_H
@@ -44,6 +44,8 @@ MySQLPreparedStatement::MySQLPreparedStatement(MySQLStmt* stmt, std::string_view
     /// Initialize variable parameters
     m_paramCount = mysql_stmt_param_count(stmt);
     m_paramsSet.assign(m_paramCount, false);
+    m_paramValues.assign(m_paramCount, 0);
+    m_paramLengths.assign(m_paramCount, 0);
     m_bind = new MySQLBind[m_paramCount];
     memset(m_bind, 0, sizeof(MySQLBind) * m_paramCount);
 
@@ -88,11 +90,10 @@ void MySQLPreparedStatement::BindParameters(PreparedStatementBase* stmt)
 
 void MySQLPreparedStatement::ClearParameters()
 {
+    //- Buffers are owned by this statement or the bound PreparedStatementBase, nothing to free
     for (uint32 i=0; i < m_paramCount; ++i)
     {
-        delete m_bind[i].length;
         m_bind[i].length = nullptr;
-        delete[] (char*)m_bind[i].buffer;
         m_bind[i].buffer = nullptr;
         m_paramsSet[i] = false;
     }
@@ -122,9 +123,9 @@ void MySQLPreparedStatement::SetParameter(const uint8 index, T value)
     m_paramsSet[index] = true;
     MYSQL_BIND* param = &m_bind[index];
     uint32 len = uint32(sizeof(T));
+    static_assert(sizeof(T) <= sizeof(uint64));
     param->buffer_type = MySQLType<T>::value;
-    delete[] static_cast<char*>(param->buffer);
-    param->buffer = new char[len];
+    param->buffer = &m_paramValues[index];
     param->buffer_length = 0;
     param->is_null_value = 0;
     param->length = nullptr; // Only != NULL for strings
@@ -144,11 +145,9 @@ void MySQLPreparedStatement::SetParameter(const uint8 index, std::nullptr_t /*va
     m_paramsSet[index] = true;
     MYSQL_BIND* param = &m_bind[index];
     param->buffer_type = MYSQL_TYPE_NULL;
-    delete[] static_cast<char*>(param->buffer);
     param->buffer = nullptr;
     param->buffer_length = 0;
     param->is_null_value = 1;
-    delete param->length;
     param->length = nullptr;
 }
 
@@ -159,14 +158,11 @@ void MySQLPreparedStatement::SetParameter(uint8 index, std::string const& value)
     MYSQL_BIND* param = &m_bind[index];
     uint32 len = uint32(value.size());
     param->buffer_type = MYSQL_TYPE_VAR_STRING;
-    delete[] static_cast<char*>(param->buffer);
-    param->buffer = new char[len];
+    param->buffer = const_cast<char*>(value.c_str()); // read only, value outlives the execution
     param->buffer_length = len;
     param->is_null_value = 0;
-    delete param->length;
-    param->length = new unsigned long(len);
-
-    memcpy(param->buffer, value.c_str(), len);
+    m_paramLengths[index] = len;
+    param->length = &m_paramLengths[index];
 }
 
 void MySQLPreparedStatement::SetParameter(uint8 index, std::vector<uint8> const& value)
@@ -176,14 +172,11 @@ void MySQLPreparedStatement::SetParameter(uint8 index, std::vector<uint8> const&
     MYSQL_BIND* param = &m_bind[index];
     uint32 len = uint32(value.size());
     param->buffer_type = MYSQL_TYPE_BLOB;
-    delete[] static_cast<char*>(param->buffer);
-    param->buffer = new char[len];
+    param->buffer = const_cast<char*>(reinterpret_cast<char const*>(value.data())); // read only, value outlives the execution
     param->buffer_length = len;
     param->is_null_value = 0;
-    delete param->length;
-    param->length = new unsigned long(len);
-
-    memcpy(param->buffer, value.data(), len);
+    m_paramLengths[index] = len;
+    param->length = &m_paramLengths[index];
 }
 
 std::string MySQLPreparedStatement::getQueryString() const
@@ -34,6 +34,7 @@ class WH_DATABASE_API MySQLPreparedStatement
 {
 friend class MySQLConnection;
 friend class PreparedStatementBase;
+friend class MySQLNonBlockingDriver;
 
 public:
     MySQLPreparedStatement(MySQLStmt* stmt, std::string_view queryString);
@@ -42,6 +43,7 @@ public:
     void BindParameters(PreparedStatementBase* stmt);
 
     uint32 GetParameterCount() const { return m_paramCount; }
+    std::string_view GetQuery() const { return m_queryString; }
 
 protected:
     void SetParameter(const uint8 index, bool value);
@@ -63,6 +65,8 @@ private:
     MySQLStmt* m_Mstmt;
     uint32 m_paramCount;
     std::vector<bool> m_paramsSet;
+    std::vector<uint64> m_paramValues;          ///< Numeric parameters, strings are bound in place
+    std::vector<unsigned long> m_paramLengths;
     MySQLBind* m_bind;
     std::string m_queryString{};
 
@@ -16,25 +16,60 @@
  */
 
 #include "PreparedStatement.h"
+#include "DatabaseStatistics.h"
 #include "Errors.h"
 #include "Log.h"
 #include "MySQLConnection.h"
 #include "MySQLPreparedStatement.h"
 #include "MySQLWorkaround.h"
+#include "QueryCompletion.h"
 #include "QueryResult.h"
 
-PreparedStatementBase::PreparedStatementBase(uint32 index, uint8 capacity) :
+// Statements kept per index, more are deleted on release
+constexpr std::size_t MAX_POOLED_STATEMENTS = 64;
+
+PreparedStatementBase::PreparedStatementBase(uint32 index, uint8 capacity, PreparedStatementPool* pool /*= nullptr*/) :
     m_index(index),
+    m_pool(pool),
     statement_data(capacity) { }
 
 PreparedStatementBase::~PreparedStatementBase() { }
 
+/*static*/ void PreparedStatementBase::Free(PreparedStatementBase* stmt)
+{
+    if (!stmt)
+        return;
+
+    if (stmt->m_pool)
+        stmt->m_pool->Release(stmt);
+    else
+        delete stmt;
+}
+
+void PreparedStatementBase::Reset()
+{
+    for (PreparedStatementData& param : statement_data)
+    {
+        if (auto str = std::get_if<std::string>(&param.data))
+            str->clear();
+        else if (auto binary = std::get_if<std::vector<uint8>>(&param.data))
+            binary->clear();
+        else
+            param.data.emplace<bool>(false);
+    }
+}
+
 //- Bind to buffer
 template<typename T>
 Warhead::Types::is_non_string_view_v<T> PreparedStatementBase::SetValidData(const uint8 index, T const& value)
 {
-    ASSERT(index < statement_data.size());
-    statement_data[index].data.emplace<T>(value);
+    if constexpr (std::is_same_v<T, std::vector<uint8>>)
+        SetValidData(index, value.data(), value.size());
+    else
+    {
+        ASSERT(index < statement_data.size());
+        statement_data[index].data.emplace<T>(value);
+    }
 }
 
 // Non template functions
@@ -47,7 +82,70 @@ void PreparedStatementBase::SetValidData(const uint8 index)
 void PreparedStatementBase::SetValidData(const uint8 index, std::string_view value)
 {
     ASSERT(index < statement_data.size());
-    statement_data[index].data.emplace<std::string>(value);
+
+    // Reuse the storage of a recycled statement
+    if (auto str = std::get_if<std::string>(&statement_data[index].data))
+        str->assign(value);
+    else
+        statement_data[index].data.emplace<std::string>(value);
+}
+
+void PreparedStatementBase::SetValidData(const uint8 index, uint8 const* value, std::size_t size)
+{
+    ASSERT(index < statement_data.size());
+
+    if (auto binary = std::get_if<std::vector<uint8>>(&statement_data[index].data))
+        binary->assign(value, value + size);
+    else
+        statement_data[index].data.emplace<std::vector<uint8>>(value, value + size);
+}
+
+//- Pool
+PreparedStatementPool::PreparedStatementPool(std::size_t statementCount) :
+    _freeLists(statementCount)
+{
+    for (FreeList& list : _freeLists)
+        list.Statements.reserve(MAX_POOLED_STATEMENTS);
+}
+
+PreparedStatementPool::~PreparedStatementPool()
+{
+    for (FreeList& list : _freeLists)
+        for (PreparedStatementBase* stmt : list.Statements)
+            delete stmt;
+}
+
+PreparedStatementBase* PreparedStatementPool::Acquire(uint32 index)
+{
+    ASSERT(index < _freeLists.size());
+
+    FreeList& list = _freeLists[index];
+    std::lock_guard<std::mutex> guard(list.Lock);
+
+    if (list.Statements.empty())
+        return nullptr;
+
+    PreparedStatementBase* stmt = list.Statements.back();
+    list.Statements.pop_back();
+    return stmt;
+}
+
+void PreparedStatementPool::Release(PreparedStatementBase* stmt)
+{
+    stmt->Reset();
+
+    FreeList& list = _freeLists[stmt->GetIndex()];
+
+    {
+        std::lock_guard<std::mutex> guard(list.Lock);
+        if (list.Statements.size() < MAX_POOLED_STATEMENTS)
+        {
+            list.Statements.emplace_back(stmt);
+            return;
+        }
+    }
+
+    delete stmt;
 }
 
 template void PreparedStatementBase::SetValidData(const uint8 index, uint8 const& value);
@@ -65,36 +163,39 @@ template void PreparedStatementBase::SetValidData(const uint8 index, std::vector
 
 //- Execution
 PreparedStatementTask::PreparedStatementTask(PreparedStatementBase* stmt, bool async) :
-    m_stmt(stmt),
-    m_result(nullptr)
+    m_stmt(stmt)
 {
     m_has_result = async; // If it's async, then there's a result
 
     if (async)
-        m_result = new PreparedQueryResultPromise();
+        m_completion = std::make_shared<QueryCompletion>(true);
 }
 
 PreparedStatementTask::~PreparedStatementTask()
 {
-    delete m_stmt;
+    PreparedStatementBase::Free(m_stmt);
 
-    if (m_has_result && m_result)
-        delete m_result;
+    // Unexecuted task completes with empty result
+    if (m_completion)
+        m_completion->SetCompleted();
 }
 
 bool PreparedStatementTask::Execute()
 {
+    if (DatabaseStatistics* statistics = m_conn->GetStatistics())
+        statistics->Add(m_stmt->GetIndex(), SQLStage::QueueWait, std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - m_queueTime));
+
     if (m_has_result)
     {
         PreparedResultSet* result = m_conn->Query(m_stmt);
         if (!result || !result->GetRowCount())
         {
             delete result;
-            m_result->set_value(PreparedQueryResult(nullptr));
+            m_completion->SetResult(PreparedQueryResult(nullptr));
             return false;
         }
 
-        m_result->set_value(PreparedQueryResult(result));
+        m_completion->SetResult(PreparedQueryResult(result));
         return true;
     }
 
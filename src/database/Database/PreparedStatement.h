@@ -23,6 +23,7 @@
 #include "Optional.h"
 #include "SQLOperation.h"
 #include <future>
+#include <mutex>
 #include <tuple>
 #include <variant>
 #include <vector>
@@ -64,15 +65,21 @@ struct PreparedStatementData
     static std::string ToString(std::nullptr_t /*value*/);
 };
 
+class PreparedStatementPool;
+
 //- Upper-level class that is used in code
 class WH_DATABASE_API PreparedStatementBase
 {
 friend class PreparedStatementTask;
+friend class PreparedStatementPool;
 
 public:
-    explicit PreparedStatementBase(uint32 index, uint8 capacity);
+    explicit PreparedStatementBase(uint32 index, uint8 capacity, PreparedStatementPool* pool = nullptr);
     virtual ~PreparedStatementBase();
 
+    //! Returns the statement to the pool it was taken from, deletes it otherwise. Use instead of delete.
+    static void Free(PreparedStatementBase* stmt);
+
     // Set numerlic and default binary
     template<typename T>
     inline Warhead::Types::is_default<T> SetData(const uint8 index, T value)
@@ -103,8 +110,7 @@ public:
     template<std::size_t Size>
     inline void SetData(const uint8 index, std::array<uint8, Size> const& value)
     {
-        std::vector<uint8> vec(value.begin(), value.end());
-        SetValidData(index, vec);
+        SetValidData(index, value.data(), value.size());
     }
 
     // Set duration
@@ -130,6 +136,10 @@ protected:
 
     void SetValidData(const uint8 index);
     void SetValidData(const uint8 index, std::string_view value);
+    void SetValidData(const uint8 index, uint8 const* value, std::size_t size);
+
+    //- Drops the arguments of the previous use, string and binary storage keeps its capacity
+    void Reset();
 
     template<typename... Ts>
     void SetDataTuple(std::tuple<Ts...> const& argsList)
@@ -145,6 +155,7 @@ protected:
     }
 
     uint32 m_index;
+    PreparedStatementPool* m_pool;
 
     //- Buffer of parameters, not tied to MySQL in any way yet
     std::vector<PreparedStatementData> statement_data;
@@ -157,7 +168,7 @@ template<typename T>
 class PreparedStatement : public PreparedStatementBase
 {
 public:
-    explicit PreparedStatement(uint32 index, uint8 capacity) : PreparedStatementBase(index, capacity)
+    explicit PreparedStatement(uint32 index, uint8 capacity, PreparedStatementPool* pool = nullptr) : PreparedStatementBase(index, capacity, pool)
     {
     }
 
@@ -166,20 +177,48 @@ private:
     PreparedStatement& operator=(PreparedStatement const& right) = delete;
 };
 
+//- Free statement objects of one database per statement index, shared by all threads.
+//- Recycled statements skip the allocation of the object and its parameter buffer.
+class WH_DATABASE_API PreparedStatementPool
+{
+public:
+    explicit PreparedStatementPool(std::size_t statementCount);
+    ~PreparedStatementPool();
+
+    //! Free statement of this index, nullptr if there is none
+    PreparedStatementBase* Acquire(uint32 index);
+    void Release(PreparedStatementBase* stmt);
+
+private:
+    struct FreeList
+    {
+        std::mutex Lock;
+        std::vector<PreparedStatementBase*> Statements;
+    };
+
+    std::vector<FreeList> _freeLists;
+
+    PreparedStatementPool(PreparedStatementPool const& right) = delete;
+    PreparedStatementPool& operator=(PreparedStatementPool const& right) = delete;
+};
+
 //- Lower-level class, enqueuable operation
 class WH_DATABASE_API PreparedStatementTask : public SQLOperation
 {
+friend class MySQLNonBlockingDriver;
+
 public:
     PreparedStatementTask(PreparedStatementBase* stmt, bool async = false);
     ~PreparedStatementTask() override;
 
     bool Execute() override;
-    PreparedQueryResultFuture GetFuture() { return m_result->get_future(); }
+    std::shared_ptr<QueryCompletion> GetCompletion() const { return m_completion; }
+    QueryCompletion* GetQueryCompletion() const override { return m_completion.get(); }
 
 protected:
     PreparedStatementBase* m_stmt;
     bool m_has_result;
-    PreparedQueryResultPromise* m_result;
+    std::shared_ptr<QueryCompletion> m_completion;
 };
 
 #endif
@@ -16,8 +16,8 @@
  */
 
 #include "QueryCallback.h"
-#include "Duration.h"
 #include "Errors.h"
+#include "QueryCompletion.h"
 
 template<typename T, typename... Args>
 inline void Construct(T& t, Args&&... args)
@@ -110,49 +110,12 @@ private:
     bool _isPrepared;
 };
 
-// Not using initialization lists to work around segmentation faults when compiling with clang without precompiled headers
-QueryCallback::QueryCallback(QueryResultFuture&& result)
-{
-    _isPrepared = false;
-    Construct(_string, std::move(result));
-}
-
-QueryCallback::QueryCallback(PreparedQueryResultFuture&& result)
-{
-    _isPrepared = true;
-    Construct(_prepared, std::move(result));
-}
-
-QueryCallback::QueryCallback(QueryCallback&& right) noexcept
-{
-    _isPrepared = right._isPrepared;
-    ConstructActiveMember(this);
-    MoveFrom(this, std::move(right));
-    _callbacks = std::move(right._callbacks);
-}
+QueryCallback::QueryCallback(std::shared_ptr<QueryCompletion> completion) :
+    _isPrepared(completion->IsPrepared()), _completion(std::move(completion)) { }
 
-QueryCallback& QueryCallback::operator=(QueryCallback&& right) noexcept
-{
-    if (this != &right)
-    {
-        if (_isPrepared != right._isPrepared)
-        {
-            DestroyActiveMember(this);
-            _isPrepared = right._isPrepared;
-            ConstructActiveMember(this);
-        }
-
-        MoveFrom(this, std::move(right));
-        _callbacks = std::move(right._callbacks);
-    }
-
-    return *this;
-}
-
-QueryCallback::~QueryCallback()
-{
-    DestroyActiveMember(this);
-}
+QueryCallback::QueryCallback(QueryCallback&& right) noexcept = default;
+QueryCallback& QueryCallback::operator=(QueryCallback&& right) noexcept = default;
+QueryCallback::~QueryCallback() = default;
 
 QueryCallback&& QueryCallback::WithCallback(std::function<void(QueryResult)>&& callback)
 {
@@ -180,50 +143,59 @@ QueryCallback&& QueryCallback::WithChainingPreparedCallback(std::function<void(Q
 
 void QueryCallback::SetNextQuery(QueryCallback&& next)
 {
-    MoveFrom(this, std::move(next));
+    ASSERT(_isPrepared == next._isPrepared);
+    _completion = std::move(next._completion);
 }
 
-bool QueryCallback::InvokeIfReady()
+bool QueryCallback::IsReady() const
 {
-    QueryCallbackData& callback = _callbacks.front();
-    auto checkStateAndReturnCompletion = [this]()
-    {
-        _callbacks.pop();
-        bool hasNext = !_isPrepared ? _string.valid() : _prepared.valid();
-        if (_callbacks.empty())
-        {
-            ASSERT(!hasNext);
-            return true;
-        }
+    return _completion && _completion->IsCompleted();
+}
 
-        // abort chain
-        if (!hasNext)
-            return true;
+bool QueryCallback::SetCompletionHandler(std::function<void()>&& handler)
+{
+    return _completion->SetHandler(std::move(handler));
+}
 
-        ASSERT(_isPrepared == _callbacks.front()._isPrepared);
+PreparedQueryResult QueryCallback::GetPreparedResult()
+{
+    ASSERT(_isPrepared && _callbacks.empty(), "Attempted to await string query or query with callbacks");
+    return _completion->TakePreparedResult();
+}
+
+bool QueryCallback::InvokeIfReady()
+{
+    if (!IsReady())
         return false;
-    };
+
+    QueryCallbackData& callback = _callbacks.front();
+
+    // Callback can set next query
+    std::shared_ptr<QueryCompletion> completion = std::move(_completion);
 
     if (!_isPrepared)
     {
-        if (_string.valid() && _string.wait_for(0s) == std::future_status::ready)
-        {
-            QueryResultFuture f(std::move(_string));
-            std::function<void(QueryCallback&, QueryResult)> cb(std::move(callback._string));
-            cb(*this, f.get());
-            return checkStateAndReturnCompletion();
-        }
+        std::function<void(QueryCallback&, QueryResult)> cb(std::move(callback._string));
+        cb(*this, completion->TakeResult());
     }
     else
     {
-        if (_prepared.valid() && _prepared.wait_for(0s) == std::future_status::ready)
-        {
-            PreparedQueryResultFuture f(std::move(_prepared));
-            std::function<void(QueryCallback&, PreparedQueryResult)> cb(std::move(callback._prepared));
-            cb(*this, f.get());
-            return checkStateAndReturnCompletion();
-        }
+        std::function<void(QueryCallback&, PreparedQueryResult)> cb(std::move(callback._prepared));
+        cb(*this, completion->TakePreparedResult());
     }
 
+    _callbacks.pop();
+    bool hasNext = _completion != nullptr;
+    if (_callbacks.empty())
+    {
+        ASSERT(!hasNext);
+        return true;
+    }
+
+    // abort chain
+    if (!hasNext)
+        return true;
+
+    ASSERT(_isPrepared == _callbacks.front()._isPrepared);
     return false;
 }
@@ -20,17 +20,19 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Define.h"
+#include <coroutine>
 #include <functional>
-#include <future>
 #include <list>
+#include <memory>
 #include <queue>
 #include <utility>
 
+class PreparedQueryAwaiter;
+
 class WH_DATABASE_API QueryCallback
 {
 public:
-    explicit QueryCallback(QueryResultFuture&& result);
-    explicit QueryCallback(PreparedQueryResultFuture&& result);
+    explicit QueryCallback(std::shared_ptr<QueryCompletion> completion);
 
     QueryCallback(QueryCallback&& right) noexcept;
     QueryCallback& operator=(QueryCallback&& right) noexcept;
@@ -42,30 +44,60 @@ public:
     QueryCallback&& WithChainingCallback(std::function<void(QueryCallback&, QueryResult)>&& callback);
     QueryCallback&& WithChainingPreparedCallback(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback);
 
-    // Moves std::future from next to this object
+    // Moves pending result from next to this object
     void SetNextQuery(QueryCallback&& next);
 
+    std::shared_ptr<QueryCompletion> GetCompletion() const { return _completion; }
+
     // returns true when completed
     bool InvokeIfReady();
 
+    // Only prepared queries without callbacks
+    PreparedQueryAwaiter operator co_await() &&;
+
 private:
-    QueryCallback(QueryCallback const& right) = delete;
-    QueryCallback& operator=(QueryCallback const& right) = delete;
+    friend class PreparedQueryAwaiter;
 
-    template<typename T> friend void ConstructActiveMember(T* obj);
-    template<typename T> friend void DestroyActiveMember(T* obj);
-    template<typename T> friend void MoveFrom(T* to, T&& from);
+    bool IsReady() const;
+    bool SetCompletionHandler(std::function<void()>&& handler);
+    PreparedQueryResult GetPreparedResult();
 
-    union
-    {
-        QueryResultFuture _string;
-        PreparedQueryResultFuture _prepared;
-    };
+    QueryCallback(QueryCallback const& right) = delete;
+    QueryCallback& operator=(QueryCallback const& right) = delete;
 
     bool _isPrepared;
+    std::shared_ptr<QueryCompletion> _completion;
 
     struct QueryCallbackData;
     std::queue<QueryCallbackData, std::list<QueryCallbackData>> _callbacks;
 };
 
+// Awaiting coroutine is resumed on its own executor
+class PreparedQueryAwaiter
+{
+public:
+    explicit PreparedQueryAwaiter(QueryCallback&& callback) : _callback(std::move(callback)) { }
+
+    bool await_ready() const { return _callback.IsReady(); }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        return _callback.SetCompletionHandler([handle, executor = handle.promise().GetExecutor()]()
+        {
+            executor(handle);
+        });
+    }
+
+    PreparedQueryResult await_resume() { return _callback.GetPreparedResult(); }
+
+private:
+    QueryCallback _callback;
+};
+
+inline PreparedQueryAwaiter QueryCallback::operator co_await() &&
+{
+    return PreparedQueryAwaiter(std::move(*this));
+}
+
 #endif // _QUERY_CALLBACK_H
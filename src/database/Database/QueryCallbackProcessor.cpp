@@ -0,0 +1,73 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QueryCallbackProcessor.h"
+#include "MPSCQueue.h"
+#include "QueryCallback.h"
+#include "QueryCompletion.h"
+
+struct QueryCallbackProcessor::PendingQuery
+{
+    explicit PendingQuery(QueryCallback&& callback) : Callback(std::move(callback)) { }
+
+    QueryCallback Callback;
+    std::atomic<PendingQuery*> QueueLink;
+};
+
+struct QueryCallbackProcessor::CompletionQueue
+{
+    MPSCQueue<PendingQuery, &PendingQuery::QueueLink> Queue;
+};
+
+QueryCallbackProcessor::QueryCallbackProcessor() : _queue(std::make_shared<CompletionQueue>()) { }
+
+QueryCallbackProcessor::~QueryCallbackProcessor() = default;
+
+void QueryCallbackProcessor::AddCallback(QueryCallback&& query)
+{
+    WaitCompletion(new PendingQuery(std::move(query)));
+}
+
+void QueryCallbackProcessor::WaitCompletion(PendingQuery* query)
+{
+    std::shared_ptr<QueryCompletion> completion = query->Callback.GetCompletion();
+
+    bool isWaiting = completion->SetHandler([queue = _queue, query]()
+    {
+        queue->Queue.Enqueue(query);
+    });
+
+    if (!isWaiting)
+        _queue->Queue.Enqueue(query);
+}
+
+void QueryCallbackProcessor::ProcessReadyCallbacks()
+{
+    PendingQuery* query;
+
+    while (_queue->Queue.Dequeue(query))
+    {
+        // Chained query waits for its own completion
+        if (!query->Callback.InvokeIfReady())
+        {
+            WaitCompletion(query);
+            continue;
+        }
+
+        delete query;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUERY_CALLBACK_PROCESSOR_H
+#define _QUERY_CALLBACK_PROCESSOR_H
+
+#include "DatabaseEnvFwd.h"
+#include "Define.h"
+#include <memory>
+
+// Workers push finished queries into a completion queue owned by this processor,
+// so an update handles only completed queries instead of checking all of them
+class WH_DATABASE_API QueryCallbackProcessor
+{
+public:
+    QueryCallbackProcessor();
+    ~QueryCallbackProcessor();
+
+    void AddCallback(QueryCallback&& query);
+    void ProcessReadyCallbacks();
+
+private:
+    QueryCallbackProcessor(QueryCallbackProcessor const&) = delete;
+    QueryCallbackProcessor& operator=(QueryCallbackProcessor const&) = delete;
+
+    struct PendingQuery;
+    struct CompletionQueue;
+
+    void WaitCompletion(PendingQuery* query);
+
+    // Shared with completion handlers, may outlive the processor
+    std::shared_ptr<CompletionQueue> _queue;
+};
+
+#endif // _QUERY_CALLBACK_PROCESSOR_H
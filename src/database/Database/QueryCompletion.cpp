@@ -0,0 +1,68 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QueryCompletion.h"
+#include "QueryResult.h"
+
+void QueryCompletion::SetResult(QueryResult result)
+{
+    _result = std::move(result);
+    Complete();
+}
+
+void QueryCompletion::SetResult(PreparedQueryResult result)
+{
+    _preparedResult = std::move(result);
+    Complete();
+}
+
+void QueryCompletion::SetCompleted()
+{
+    if (!IsCompleted())
+        Complete();
+}
+
+void QueryCompletion::SetRejected()
+{
+    _rejected.store(true, std::memory_order_release);
+    SetCompleted();
+}
+
+bool QueryCompletion::SetHandler(std::function<void()>&& handler)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (IsCompleted())
+        return false;
+
+    _handler = std::move(handler);
+    return true;
+}
+
+void QueryCompletion::Complete()
+{
+    std::function<void()> handler;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _completed.store(true, std::memory_order_release);
+        handler = std::move(_handler);
+    }
+
+    if (handler)
+        handler();
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUERY_COMPLETION_H
+#define _QUERY_COMPLETION_H
+
+#include "DatabaseEnvFwd.h"
+#include "Define.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+// Result state shared by an async query task and its QueryCallback.
+// Worker sets the result and runs the handler, waiting side doesn't poll
+class WH_DATABASE_API QueryCompletion
+{
+public:
+    explicit QueryCompletion(bool isPrepared) : _isPrepared(isPrepared) { }
+
+    // Worker thread
+    void SetResult(QueryResult result);
+    void SetResult(PreparedQueryResult result);
+
+    // Empty result, for tasks destroyed without execution
+    void SetCompleted();
+
+    // Empty result, the pool did not run the query while the database was unavailable
+    void SetRejected();
+
+    // Returns false if already completed, handler isn't called then
+    bool SetHandler(std::function<void()>&& handler);
+
+    inline bool IsPrepared() const { return _isPrepared; }
+    inline bool IsCompleted() const { return _completed.load(std::memory_order_acquire); }
+    inline bool IsRejected() const { return _rejected.load(std::memory_order_acquire); }
+
+    // Only after completion
+    QueryResult TakeResult() { return std::move(_result); }
+    PreparedQueryResult TakePreparedResult() { return std::move(_preparedResult); }
+
+private:
+    void Complete();
+
+    bool _isPrepared;
+    QueryResult _result;
+    PreparedQueryResult _preparedResult;
+
+    std::mutex _lock;
+    std::atomic<bool> _completed{ false };
+    std::atomic<bool> _rejected{ false };
+    std::function<void()> _handler;
+};
+
+#endif // _QUERY_COMPLETION_H
@@ -62,7 +62,7 @@ SQLQueryHolderBase::~SQLQueryHolderBase()
     {
         /// if the result was never used, free the resources
         /// results used already (getresult called) are expected to be deleted
-        delete query.first;
+        PreparedStatementBase::Free(query.first);
     }
 }
 
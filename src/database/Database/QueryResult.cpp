@@ -21,10 +21,14 @@
 #include "Log.h"
 #include "MySQLHacks.h"
 #include "MySQLWorkaround.h"
+#include <algorithm>
 
 namespace
 {
-    static uint32 SizeForType(MYSQL_FIELD* field)
+    //! Stream buffers hold chunkRows rows, longer strings are fetched into an own buffer per cell
+    constexpr unsigned long MAX_STREAM_COLUMN_SIZE = 1024;
+
+    static uint32 SizeForType(MYSQL_FIELD* field, bool stream)
     {
         switch (field->type)
         {
@@ -56,6 +60,10 @@ namespace
             case MYSQL_TYPE_BLOB:
             case MYSQL_TYPE_STRING:
             case MYSQL_TYPE_VAR_STRING:
+                // max_length is only known once the result is stored, a stream gets the declared length
+                if (stream)
+                    return std::min(field->length, MAX_STREAM_COLUMN_SIZE) + 1;
+
                 return field->max_length + 1;
 
             case MYSQL_TYPE_DECIMAL:
@@ -245,10 +253,12 @@ void ResultSet::AssertRows(std::size_t sizeRows)
     ASSERT(sizeRows == _fieldCount);
 }
 
-PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount) :
+PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount, bool resultStored /*= false*/) :
+    m_currentRowPosition(NO_CURRENT_ROW),
     m_rowCount(rowCount),
     m_rowPosition(0),
     m_fieldCount(fieldCount),
+    m_chunkRows(0),
     m_rBind(nullptr),
     m_stmt(stmt),
     m_metadataResult(result)
@@ -256,6 +266,77 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
     if (!m_metadataResult)
         return;
 
+    //- This is where we store the (entire) resultset, unless a non-blocking connection already did
+    if (!resultStored && mysql_stmt_store_result(m_stmt))
+    {
+        LOG_WARN("sql.sql", "{}:mysql_stmt_store_result, cannot bind result from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(m_stmt));
+        return;
+    }
+
+    m_rowCount = mysql_stmt_num_rows(m_stmt);
+
+    if (!BindResult(m_rowCount))
+        return;
+
+    m_rowCount = FetchRows(m_rowCount);
+
+    /// All data is buffered, let go of mysql c api structures
+    mysql_stmt_free_result(m_stmt);
+}
+
+PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint32 fieldCount) :
+    m_currentRowPosition(NO_CURRENT_ROW),
+    m_rowCount(0),
+    m_rowPosition(0),
+    m_fieldCount(fieldCount),
+    m_chunkRows(0),
+    m_rBind(nullptr),
+    m_stmt(stmt),
+    m_metadataResult(result)
+{
+}
+
+std::unique_ptr<PreparedResultSet> PreparedResultSet::OpenStream(MySQLStmt* stmt, MySQLResult* result, uint32 fieldCount, uint32 chunkRows)
+{
+    ASSERT(chunkRows > 0);
+
+    std::unique_ptr<PreparedResultSet> stream(new PreparedResultSet(stmt, result, fieldCount));
+    stream->m_chunkRows = chunkRows;
+
+    //- Nothing is stored client side, rows are read from the server by mysql_stmt_fetch
+    if (stream->m_metadataResult && !stream->BindResult(chunkRows))
+        stream->m_chunkRows = 0;
+
+    return stream;
+}
+
+PreparedResultSet::~PreparedResultSet()
+{
+    //- Discards rows of a stream that was not read to the end
+    if (m_chunkRows)
+        mysql_stmt_free_result(m_stmt);
+
+    CleanUp();
+}
+
+bool PreparedResultSet::NextChunk()
+{
+    if (!m_chunkRows)
+        return false;
+
+    //- Rewind every column, the previous chunk is overwritten
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+        m_stmt->bind[i].buffer = m_rBind[i].buffer;
+
+    m_rowPosition = 0;
+    m_currentRowPosition = NO_CURRENT_ROW;
+    m_overflow.clear();
+    m_rowCount = FetchRows(m_chunkRows);
+    return m_rowCount > 0;
+}
+
+bool PreparedResultSet::BindResult(uint64 rowCapacity)
+{
     if (m_stmt->bind_result_done)
     {
         delete[] m_stmt->bind->length;
@@ -274,18 +355,6 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
     memset(m_rBind, 0, sizeof(MySQLBind) * m_fieldCount);
     memset(m_length, 0, sizeof(unsigned long) * m_fieldCount);
 
-    //- This is where we store the (entire) resultset
-    if (mysql_stmt_store_result(m_stmt))
-    {
-        LOG_WARN("sql.sql", "{}:mysql_stmt_store_result, cannot bind result from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(m_stmt));
-        delete[] m_rBind;
-        delete[] m_isNull;
-        delete[] m_length;
-        return;
-    }
-
-    m_rowCount = mysql_stmt_num_rows(m_stmt);
-
     //- This is where we prepare the buffer based on metadata
     MySQLField* field = reinterpret_cast<MySQLField*>(mysql_fetch_fields(m_metadataResult));
     m_fieldMetadata.resize(m_fieldCount);
@@ -293,7 +362,7 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
 
     for (uint32 i = 0; i < m_fieldCount; ++i)
     {
-        uint32 size = SizeForType(&field[i]);
+        uint32 size = SizeForType(&field[i], m_chunkRows > 0);
         rowSize += size;
 
         InitializeDatabaseFieldMetadata(&m_fieldMetadata[i], &field[i], i);
@@ -306,11 +375,16 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
         m_rBind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
     }
 
-    char* dataBuffer = new char[rowSize * m_rowCount];
-    for (uint32 i = 0, offset = 0; i < m_fieldCount; ++i)
+    //- Columnar layout: every column is one contiguous block of its native type
+    char* dataBuffer = new char[rowSize * rowCapacity];
+    m_columns.resize(m_fieldCount);
+
+    for (std::size_t i = 0, offset = 0; i < m_fieldCount; ++i)
     {
         m_rBind[i].buffer = dataBuffer + offset;
-        offset += m_rBind[i].buffer_length;
+        m_columns[i].Data = dataBuffer + offset;
+        m_columns[i].Stride = m_rBind[i].buffer_length;
+        offset += m_rBind[i].buffer_length * rowCapacity;
     }
 
     //- This is where we bind the bind the buffer to the statement
@@ -321,22 +395,53 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
         CleanUp();
         delete[] m_isNull;
         delete[] m_length;
-        return;
+        return false;
     }
 
-    m_rows.resize(uint32(m_rowCount) * m_fieldCount);
+    m_lengths.resize(std::size_t(rowCapacity) * m_fieldCount);
+    m_cellStates.resize(std::size_t(rowCapacity) * m_fieldCount);
+    m_currentRow.resize(m_fieldCount);
+    return true;
+}
+
+uint64 PreparedResultSet::FetchRows(uint64 maxRows)
+{
+    /// Only called in low-level code, reads up to maxRows rows into the bound buffers
+    uint64 row = 0;
 
-    while (_NextRow())
+    for (; row < maxRows; ++row)
     {
+        int retval = mysql_stmt_fetch(m_stmt);
+        if (retval == MYSQL_NO_DATA)
+            break;
+
+        if (retval != 0 && retval != MYSQL_DATA_TRUNCATED)
+        {
+            LOG_WARN("sql.sql", "{}:mysql_stmt_fetch, cannot fetch row from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(m_stmt));
+            break;
+        }
+
         for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
         {
-            m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetMetadata(&m_fieldMetadata[fIndex]);
+            std::size_t const cell = std::size_t(row) * m_fieldCount + fIndex;
+            void* buffer = m_stmt->bind[fIndex].buffer;
 
             unsigned long buffer_length = m_rBind[fIndex].buffer_length;
             unsigned long fetched_length = *m_rBind[fIndex].length;
-            if (!*m_rBind[fIndex].is_null)
+            m_cellStates[cell] = *m_rBind[fIndex].is_null ? CELL_NULL : CELL_VALUE;
+            m_lengths[cell] = fetched_length;
+
+            //- Truncated, only the first buffer_length bytes are in the buffer
+            if (m_cellStates[cell] == CELL_VALUE && fetched_length > buffer_length)
+            {
+                if (FetchOverflow(cell, fIndex, fetched_length))
+                    m_cellStates[cell] = CELL_OVERFLOW;
+                else
+                    m_lengths[cell] = buffer_length;
+            }
+
+            if (m_cellStates[cell] == CELL_VALUE)
             {
-                void* buffer = m_stmt->bind[fIndex].buffer;
                 switch (m_rBind[fIndex].buffer_type)
                 {
                 case MYSQL_TYPE_TINY_BLOB:
@@ -356,30 +461,53 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
                 default:
                     break;
                 }
-
-                m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetByteValue((char const*)buffer, fetched_length);
-
-                // move buffer pointer to next part
-                m_stmt->bind[fIndex].buffer = (char*)buffer + rowSize;
-            }
-            else
-            {
-                m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetByteValue(nullptr, *m_rBind[fIndex].length);
             }
-        }
 
-        m_rowPosition++;
+            // move buffer pointer to the next row of this column, NULL cells keep their slot so rows stay addressable
+            m_stmt->bind[fIndex].buffer = (char*)buffer + buffer_length;
+        }
     }
 
-    m_rowPosition = 0;
-
-    /// All data is buffered, let go of mysql c api structures
-    mysql_stmt_free_result(m_stmt);
+    return row;
 }
 
-PreparedResultSet::~PreparedResultSet()
+bool PreparedResultSet::FetchOverflow(std::size_t cell, uint32 index, unsigned long length)
 {
-    CleanUp();
+    switch (m_rBind[index].buffer_type)
+    {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+            break;
+        default:
+            return false;
+    }
+
+    std::string& value = m_overflow[cell];
+    value.resize(length);
+
+    unsigned long fetchedLength = 0;
+    MySQLBool isNull = 0;
+
+    MySQLBind bind;
+    memset(&bind, 0, sizeof(MySQLBind));
+    bind.buffer_type = m_rBind[index].buffer_type;
+    bind.buffer = value.data();
+    bind.buffer_length = length;
+    bind.length = &fetchedLength;
+    bind.is_null = &isNull;
+
+    if (mysql_stmt_fetch_column(m_stmt, &bind, index, 0))
+    {
+        LOG_WARN("sql.sql", "{}:mysql_stmt_fetch_column, cannot fetch column {} ({} bytes), value is truncated. Error: {}", __FUNCTION__, index, length, mysql_stmt_error(m_stmt));
+        m_overflow.erase(cell);
+        return false;
+    }
+
+    return true;
 }
 
 bool PreparedResultSet::NextRow()
@@ -392,34 +520,38 @@ bool PreparedResultSet::NextRow()
     return true;
 }
 
-bool PreparedResultSet::_NextRow()
-{
-    /// Only called in low-level code, namely the constructor
-    /// Will iterate over every row of data and buffer it
-    if (m_rowPosition >= m_rowCount)
-        return false;
-
-    int retval = mysql_stmt_fetch(m_stmt);
-    return retval == 0 || retval == MYSQL_DATA_TRUNCATED;
-}
-
 Field* PreparedResultSet::Fetch() const
 {
     ASSERT(m_rowPosition < m_rowCount);
-    return const_cast<Field*>(&m_rows[uint32(m_rowPosition) * m_fieldCount]);
+
+    //- Fields are built for one row at a time, they point into the column buffers
+    if (m_currentRowPosition != m_rowPosition)
+    {
+        for (uint32 i = 0; i < m_fieldCount; ++i)
+        {
+            m_currentRow[i].SetMetadata(&m_fieldMetadata[i]);
+            m_currentRow[i].SetByteValue(GetCellValue(m_rowPosition, i), m_lengths[std::size_t(m_rowPosition) * m_fieldCount + i]);
+        }
+
+        m_currentRowPosition = m_rowPosition;
+    }
+
+    return m_currentRow.data();
 }
 
 Field const& PreparedResultSet::operator[](std::size_t index) const
 {
-    ASSERT(m_rowPosition < m_rowCount);
     ASSERT(index < m_fieldCount);
-    return m_rows[uint32(m_rowPosition) * m_fieldCount + index];
+    return Fetch()[index];
 }
 
 void PreparedResultSet::CleanUp()
 {
     if (m_metadataResult)
+    {
         mysql_free_result(m_metadataResult);
+        m_metadataResult = nullptr;
+    }
 
     if (m_rBind)
     {
@@ -429,6 +561,22 @@ void PreparedResultSet::CleanUp()
     }
 }
 
+void PreparedResultSet::AssertColumnCount(std::size_t count) const
+{
+    ASSERT(count == m_fieldCount, "> Tuple size != count fields");
+}
+
+void PreparedResultSet::AssertColumnType(uint32 index, DatabaseFieldTypes type) const
+{
+    DatabaseFieldTypes columnType = m_fieldMetadata[index].Type;
+
+    // NULL literal columns are read as default values
+    if (columnType == type || columnType == DatabaseFieldTypes::Null)
+        return;
+
+    ASSERT(false, "> Column {} ('{}', {}) can not be read as {}", index, m_fieldMetadata[index].Alias, m_fieldMetadata[index].TypeName, static_cast<uint32>(type));
+}
+
 void PreparedResultSet::AssertRows(std::size_t sizeRows)
 {
     ASSERT(m_rowPosition < m_rowCount);
@@ -21,9 +21,43 @@
 #include "DatabaseEnvFwd.h"
 #include "Define.h"
 #include "Field.h"
+#include <cstring>
+#include <limits>
+#include <string>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+template<typename... Ts>
+class PreparedResultRows;
+
+namespace Warhead::Impl
+{
+    // Column type a typed row read expects, strings are read without a copy as std::string_view
+    template<typename T>
+    constexpr DatabaseFieldTypes GetColumnFieldType()
+    {
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int8> || std::is_same_v<T, uint8>)
+            return DatabaseFieldTypes::Int8;
+        else if constexpr (std::is_same_v<T, int16> || std::is_same_v<T, uint16>)
+            return DatabaseFieldTypes::Int16;
+        else if constexpr (std::is_same_v<T, int32> || std::is_same_v<T, uint32>)
+            return DatabaseFieldTypes::Int32;
+        else if constexpr (std::is_same_v<T, int64> || std::is_same_v<T, uint64>)
+            return DatabaseFieldTypes::Int64;
+        else if constexpr (std::is_same_v<T, float>)
+            return DatabaseFieldTypes::Float;
+        else if constexpr (std::is_same_v<T, double>)
+            return DatabaseFieldTypes::Double;
+        else
+        {
+            static_assert(std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>, "Unsupported column type for typed rows");
+            return DatabaseFieldTypes::Binary;
+        }
+    }
+}
+
 class WH_DATABASE_API ResultSet
 {
 public:
@@ -74,9 +108,16 @@ private:
 class WH_DATABASE_API PreparedResultSet
 {
 public:
-    PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount);
+    PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount, bool resultStored = false);
     ~PreparedResultSet();
 
+    //! Unbuffered result of an executed statement, rows are read from the server chunk by chunk into one reused buffer.
+    //! Holds the statement until destroyed, no other query may run on the connection meanwhile.
+    static std::unique_ptr<PreparedResultSet> OpenStream(MySQLStmt* stmt, MySQLResult* result, uint32 fieldCount, uint32 chunkRows);
+
+    //! Replaces the rows with the next chunk of a stream, false once all rows were read
+    bool NextChunk();
+
     bool NextRow();
     [[nodiscard]] uint64 GetRowCount() const { return m_rowCount; }
     [[nodiscard]] uint32 GetFieldCount() const { return m_fieldCount; }
@@ -91,34 +132,150 @@ public:
 
         std::tuple<Ts...> theTuple = {};
 
-        std::apply([this](Ts&... args)
+        Field* fields = Fetch();
+
+        std::apply([fields](Ts&... args)
         {
             uint8 index{ 0 };
-            ((args = m_rows[uint32(m_rowPosition) * m_fieldCount + index].Get<Ts>(), index++), ...);
+            ((args = fields[index].Get<Ts>(), index++), ...);
         }, theTuple);
 
         return theTuple;
     }
 
+    //! Typed iteration over all rows: column types are checked once here instead of on every Field::Get,
+    //! values are read straight from the column buffers without building Field objects.
+    //! for (auto const& [id, name] : result->Rows<uint32, std::string_view>())
+    //! Views point into the result buffer and live as long as the result set.
+    template<typename... Ts>
+    PreparedResultRows<Ts...> Rows() const
+    {
+        AssertColumnCount(sizeof...(Ts));
+
+        uint32 index{ 0 };
+        (AssertColumnType(index++, Warhead::Impl::GetColumnFieldType<Ts>()), ...);
+
+        return PreparedResultRows<Ts...>(this);
+    }
+
 protected:
+    struct ColumnBuffer
+    {
+        char const* Data{ nullptr };
+        std::size_t Stride{ 0 };      ///< Bytes per row
+    };
+
     std::vector<QueryResultFieldMetadata> m_fieldMetadata;
-    std::vector<Field> m_rows;
+    std::vector<ColumnBuffer> m_columns;
+    enum CellState : uint8
+    {
+        CELL_VALUE,
+        CELL_NULL,
+        CELL_OVERFLOW                       ///< Longer than the column buffer, stored in m_overflow
+    };
+
+    std::vector<unsigned long> m_lengths;   ///< Per cell, row major
+    std::vector<uint8> m_cellStates;        ///< Per cell, row major
+    std::unordered_map<std::size_t, std::string> m_overflow;
+    mutable std::vector<Field> m_currentRow;  ///< Fields of one row, built by Fetch
+    mutable uint64 m_currentRowPosition;
     uint64 m_rowCount;
     uint64 m_rowPosition;
     uint32 m_fieldCount;
+    uint32 m_chunkRows;               ///< Rows per chunk of a stream, 0 for a stored result
+
+    static constexpr uint64 NO_CURRENT_ROW = std::numeric_limits<uint64>::max();
 
 private:
+    PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint32 fieldCount);
+
     MySQLBind* m_rBind;
     MySQLStmt* m_stmt;
     MySQLResult* m_metadataResult;    ///< Field metadata, returned by mysql_stmt_result_metadata
 
     void CleanUp();
-    bool _NextRow();
+    bool BindResult(uint64 rowCapacity);
+    uint64 FetchRows(uint64 maxRows);
+    bool FetchOverflow(std::size_t cell, uint32 index, unsigned long length);
 
     void AssertRows(std::size_t sizeRows);
+    void AssertColumnCount(std::size_t count) const;
+    void AssertColumnType(uint32 index, DatabaseFieldTypes type) const;
+
+    template<typename... Ts>
+    friend class PreparedResultRows;
+
+    //! Null for a NULL cell
+    char const* GetCellValue(uint64 row, uint32 index) const
+    {
+        std::size_t const cell = row * m_fieldCount + index;
+
+        switch (m_cellStates[cell])
+        {
+            case CELL_NULL:
+                return nullptr;
+            case CELL_OVERFLOW:
+                return m_overflow.at(cell).data();
+            default:
+                return m_columns[index].Data + row * m_columns[index].Stride;
+        }
+    }
+
+    template<typename T>
+    T ReadColumn(uint64 row, uint32 index) const
+    {
+        char const* cell = GetCellValue(row, index);
+        if (!cell)
+            return T{};
+
+        if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+            return T(cell, m_lengths[row * m_fieldCount + index]);
+        else if constexpr (std::is_same_v<T, bool>)
+            return *cell != 0;
+        else
+        {
+            T value;
+            std::memcpy(&value, cell, sizeof(T));
+            return value;
+        }
+    }
+
+    template<typename... Ts, std::size_t... I>
+    std::tuple<Ts...> ReadRow(uint64 row, std::index_sequence<I...>) const
+    {
+        return std::tuple<Ts...>(ReadColumn<Ts>(row, I)...);
+    }
 
     PreparedResultSet(PreparedResultSet const& right) = delete;
     PreparedResultSet& operator=(PreparedResultSet const& right) = delete;
 };
 
+template<typename... Ts>
+class PreparedResultRows
+{
+public:
+    class iterator
+    {
+    public:
+        iterator(PreparedResultSet const* result, uint64 row) : _result(result), _row(row) { }
+
+        std::tuple<Ts...> operator*() const { return _result->template ReadRow<Ts...>(_row, std::index_sequence_for<Ts...>{}); }
+        iterator& operator++() { ++_row; return *this; }
+        bool operator==(iterator const& right) const { return _row == right._row; }
+        bool operator!=(iterator const& right) const { return _row != right._row; }
+
+    private:
+        PreparedResultSet const* _result;
+        uint64 _row;
+    };
+
+    explicit PreparedResultRows(PreparedResultSet const* result) : _result(result) { }
+
+    iterator begin() const { return iterator(_result, 0); }
+    iterator end() const { return iterator(_result, _result->GetRowCount()); }
+
+private:
+    PreparedResultSet const* _result;
+};
+
 #endif
@@ -20,6 +20,7 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Define.h"
+#include "Duration.h"
 #include <variant>
 
 //- Type specifier of our element data
@@ -53,7 +54,12 @@ public:
     virtual bool Execute() = 0;
     virtual void SetConnection(MySQLConnection* con) { m_conn = con; }
 
+    //! Only set for queries with a result, the pool sheds nothing else under overload
+    virtual QueryCompletion* GetQueryCompletion() const { return nullptr; }
+
     MySQLConnection* m_conn{nullptr};
+    SQLPriority m_priority{ SQLPriority::Normal };
+    TimePoint m_queueTime;
 
 private:
     SQLOperation(SQLOperation const& right) = delete;
@@ -64,7 +64,7 @@ void TransactionBase::Cleanup()
                     PreparedStatementBase* stmt = std::get<PreparedStatementBase*>(data.element);
                     ASSERT(stmt);
 
-                    delete stmt;
+                    PreparedStatementBase::Free(stmt);
                 }
                 catch (const std::bad_variant_access& ex)
                 {
@@ -179,6 +179,29 @@ bool TransactionWithResultTask::Execute()
     return false;
 }
 
+bool BatchedTransactionTask::Execute()
+{
+    int errorCode = TryExecute();
+    if (!errorCode)
+        return true;
+
+    if (errorCode == ER_LOCK_DEADLOCK)
+        return TransactionTask::Execute();
+
+    LOG_WARN("sql.sql", "Batched SQL transaction failed with error {}, executing {} statements one by one.", errorCode, m_trans->GetSize());
+
+    for (SQLElementData const& data : m_trans->m_queries)
+    {
+        if (data.type == SQL_ELEMENT_PREPARED)
+            m_conn->Execute(std::get<PreparedStatementBase*>(data.element));
+        else
+            m_conn->Execute(std::get<std::string>(data.element));
+    }
+
+    CleanupOnFailure();
+    return false;
+}
+
 bool TransactionCallback::InvokeIfReady()
 {
     if (m_future.valid() && m_future.wait_for(0s) == std::future_status::ready)
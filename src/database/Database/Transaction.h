@@ -31,6 +31,7 @@
 class WH_DATABASE_API TransactionBase
 {
     friend class TransactionTask;
+    friend class BatchedTransactionTask;
     friend class MySQLConnection;
 
     template <typename T>
@@ -106,6 +107,18 @@ protected:
     TransactionPromise m_result;
 };
 
+/*! Write-behind batch of unrelated one-way statements.
+    If the batch fails for any reason other than a deadlock, every statement
+    is re-run standalone so one bad row does not drop the whole batch. */
+class WH_DATABASE_API BatchedTransactionTask : public TransactionTask
+{
+public:
+    BatchedTransactionTask(std::shared_ptr<TransactionBase> trans) : TransactionTask(std::move(trans)) { }
+
+protected:
+    bool Execute() override;
+};
+
 class WH_DATABASE_API TransactionCallback
 {
 public:
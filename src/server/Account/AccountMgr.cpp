@@ -16,6 +16,7 @@
  */
 
 #include "AccountMgr.h"
+#include "AccountAuthCache.h"
 #include "Containers.h"
 #include "DatabaseEnv.h"
 #include "DiscordSharedDefines.h"
@@ -37,39 +38,46 @@ void AccountMgr::Initialize()
 
     StopWatch sw;
 
-    _accounts.clear();
+    _accounts.Clear();
 
-    auto result = DiscordDatabase.Query(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_ACCOUNTS));
-    if (!result)
+    // Streamed in chunks, memory during load does not grow with the table
+    uint64 rows = DiscordDatabase.QueryStream(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_ACCOUNTS), [this](PreparedResultSet const& chunk)
+    {
+        for (auto const& [id, name, guildID, realmName] : chunk.Rows<uint32, std::string_view, int64, std::string_view>())
+            AddAccountInfo(id, name, guildID, realmName);
+    });
+
+    if (!rows)
     {
         LOG_ERROR("server.loading", "> Not found accounts");
         return;
     }
 
-    do
-    {
-        auto const& [id, name, guildID, realmName] = result->FetchTuple<uint32, std::string_view, int64, std::string_view>();
-        AddAccountInfo(id, name, guildID, realmName);
-    } while (result->NextRow());
+    auto memory = _accounts.GetMemoryUsage();
 
-    LOG_INFO("server.loading", "> Loaded {} accounts in {}", _accounts.size(), sw);
+    LOG_INFO("server.loading", "> Loaded {} accounts in {}", _accounts.Size(), sw);
+    LOG_INFO("server.loading", "> Account store memory {} bytes. Records {}, by id {}, by name {}, by guild {}",
+        memory.Total(), memory.Records, memory.ByID, memory.ByName, memory.ByGuild);
     LOG_INFO("server.loading", "");
 }
 
 void AccountMgr::Update()
 {
+    {
+        std::lock_guard<std::mutex> guard(_transactionProcessorLock);
+        _transactionProcessor.ProcessReadyCallbacks();
+    }
+
+    std::lock_guard<std::mutex> guard(_queryProcessorLock);
     _queryProcessor.ProcessReadyCallbacks();
 }
 
 void AccountMgr::AddAccountInfo(DiscordAccountInfo&& info)
 {
-    if (GetAccountInfo(info.ID))
-    {
-        LOG_ERROR("account", "> Account with id {} exist", info.ID);
-        return;
-    }
+    uint32 id = info.ID;
 
-    _accounts.emplace(info.ID, std::move(info));
+    if (!_accounts.Add(std::move(info)))
+        LOG_ERROR("account", "> Account with id {} exist", id);
 }
 
 void AccountMgr::AddAccountInfo(uint32 id, std::string_view name, int64 guildID, std::string_view realmName)
@@ -77,9 +85,28 @@ void AccountMgr::AddAccountInfo(uint32 id, std::string_view name, int64 guildID,
     AddAccountInfo(std::move(DiscordAccountInfo(id, name, guildID, realmName)));
 }
 
-DiscordAccountInfo const* AccountMgr::GetAccountInfo(uint32 id)
+void AccountMgr::UpdateAccountInfo(DiscordAccountInfo&& info)
 {
-    return Warhead::Containers::MapGetValuePtr(_accounts, id);
+    uint32 id = info.ID;
+    std::string name = info.Name;
+
+    if (!_accounts.Update(std::move(info)))
+        LOG_ERROR("account", "> Account name '{}' for id {} is used by another account", name, id);
+}
+
+void AccountMgr::RemoveAccountInfo(uint32 id)
+{
+    _accounts.Remove(id);
+}
+
+DiscordAccountInfoPtr AccountMgr::GetAccountInfo(uint32 id)
+{
+    return _accounts.GetByID(id);
+}
+
+std::vector<DiscordAccountInfoPtr> AccountMgr::GetGuildAccounts(int64 guildID)
+{
+    return _accounts.GetByGuild(guildID);
 }
 
 AccountResponceResult AccountMgr::CreateAccount(std::string username, std::string key, int64 guildID, std::string_view realmName /*= {}*/)
@@ -104,17 +131,35 @@ AccountResponceResult AccountMgr::CreateAccount(std::string username, std::strin
     // INSERT INTO account (`Name`, `Salt`, `Verifier`, `GuildID`, `RealmName`, `JoinDate`) VALUES (?, ?, ?, ?, ?, NOW())
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_INS_ACCOUNT);
     stmt->SetArguments(username, salt, verifier, guildID, realmName);
-    DiscordDatabase.Execute(stmt);
 
-    CheckAccount(username, [this, username, guildID, realmName](uint32 accountID)
+    auto trans = DiscordDatabase.BeginTransaction();
+    trans->Append(stmt);
+
+    // Called from bot threads
+    std::lock_guard<std::mutex> guard(_transactionProcessorLock);
+
+    // Cache and read back only after the insert is committed, the read may run on another connection
+    _transactionProcessor.AddCallback(DiscordDatabase.AsyncCommitTransaction(trans)).AfterComplete([this, username, guildID, realmName = std::string(realmName)](bool success)
     {
-        if (!accountID)
+        if (!success)
         {
-            LOG_INFO("account", "> Incorrect account name '{}' at add info to store", username);
+            LOG_ERROR("account", "> Failed to create account '{}'", username);
             return;
         }
 
-        AddAccountInfo(accountID, username, guildID, realmName);
+        sAccountAuthCache->Invalidate(username);
+
+        CheckAccount(username, [this, username, guildID, realmName](uint32 accountID)
+        {
+            if (!accountID)
+            {
+                LOG_INFO("account", "> Incorrect account name '{}' at add info to store", username);
+                return;
+            }
+
+            // Replaces a stale record left under the same id
+            UpdateAccountInfo(DiscordAccountInfo(accountID, username, guildID, realmName));
+        });
     });
 
     return AccountResponceResult::Ok;
@@ -122,29 +167,20 @@ AccountResponceResult AccountMgr::CreateAccount(std::string username, std::strin
 
 uint32 AccountMgr::GetID(std::string_view accountName)
 {
-    for (auto const& [ID, info] : _accounts)
-        if (StringEqualI(info.Name, accountName))
-            return ID;
-
-    return 0;
+    auto account = _accounts.GetByName(accountName);
+    return account ? account->ID : 0;
 }
 
-std::string_view AccountMgr::GetName(uint32 id)
+std::string AccountMgr::GetName(uint32 id)
 {
-    auto const& itr = _accounts.find(id);
-    if (itr != _accounts.end())
-        return std::string_view{ itr->second.Name };
-
-    return {};
+    auto account = _accounts.GetByID(id);
+    return account ? account->Name : std::string{};
 }
 
-std::string_view AccountMgr::GetRealmName(uint32 id)
+std::string AccountMgr::GetRealmName(uint32 id)
 {
-    auto const& itr = _accounts.find(id);
-    if (itr != _accounts.end())
-        return std::string_view{ itr->second.RealmName };
-
-    return {};
+    auto account = _accounts.GetByID(id);
+    return account ? account->RealmName : std::string{};
 }
 
 void AccountMgr::CheckAccount(std::string_view accountName, std::function<void(uint32)>&& execute)
@@ -152,6 +188,9 @@ void AccountMgr::CheckAccount(std::string_view accountName, std::function<void(u
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_ACCOUNT_ID_BY_USERNAME);
     stmt->SetArguments(accountName);
 
+    // Called from bot threads
+    std::lock_guard<std::mutex> guard(_queryProcessorLock);
+
     _queryProcessor.AddCallback(DiscordDatabase.AsyncQuery(stmt).WithPreparedCallback([execute = std::move(execute)](PreparedQueryResult result)
     {
         if (!result)
@@ -183,7 +222,24 @@ AccountResponceResult AccountMgr::ChangeKey(std::string_view name, std::string n
 
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_UPD_LOGON);
     stmt->SetArguments(salt, verifier, accountID);
-    DiscordDatabase.Execute(stmt);
+
+    auto trans = DiscordDatabase.BeginTransaction();
+    trans->Append(stmt);
+
+    // Called from bot threads
+    std::lock_guard<std::mutex> guard(_transactionProcessorLock);
+
+    // Auth reads are not ordered against the update, drop the cached key once the new one is committed
+    _transactionProcessor.AddCallback(DiscordDatabase.AsyncCommitTransactionOrdered(accountID, trans)).AfterComplete([safeUser](bool success)
+    {
+        if (!success)
+        {
+            LOG_ERROR("account", "> Failed to change key for account '{}'", safeUser);
+            return;
+        }
+
+        sAccountAuthCache->Invalidate(safeUser);
+    });
 
     return AccountResponceResult::Ok;
 }
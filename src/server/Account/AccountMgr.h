@@ -18,30 +18,21 @@
 #ifndef _ACCOUNT_MGR_H
 #define _ACCOUNT_MGR_H
 
+#include "AccountStore.h"
 #include "AsyncCallbackProcessor.h"
 #include "DatabaseEnvFwd.h"
 #include "Define.h"
+#include "QueryCallbackProcessor.h"
+#include "Transaction.h"
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 
 constexpr auto MAX_ACCOUNT_STR = 50;
 constexpr auto MAX_PASS_STR = 50;
 
 enum class AccountResponceResult : uint8;
 
-struct DiscordAccountInfo
-{
-    DiscordAccountInfo(uint32 id, std::string_view name, int64 guildID, std::string_view realmName) :
-        ID(id), Name(name), GuildID(guildID), RealmName(realmName) { }
-
-    uint32 ID{ 0 };
-    int64 GuildID{ 0 };
-    std::string Name;
-    std::string RealmName;
-};
-
 /// The Discord
 class WH_SERVER_API AccountMgr
 {
@@ -56,20 +47,27 @@ public:
     AccountResponceResult ChangeKey(std::string_view name, std::string newPassword);
     void CheckAccount(std::string_view accountName, std::function<void(uint32)>&& execute);
     uint32 GetID(std::string_view accountName);
-    std::string_view GetName(uint32 id);
-    std::string_view GetRealmName(uint32 id);
+    std::string GetName(uint32 id);
+    std::string GetRealmName(uint32 id);
     std::string GetRandomKey();
 
     void AddAccountInfo(DiscordAccountInfo&& info);
     void AddAccountInfo(uint32 id, std::string_view name, int64 guildID, std::string_view realmName);
-    inline auto GetAllAccountsInfo() { return &_accounts; }
+    void UpdateAccountInfo(DiscordAccountInfo&& info);
+    void RemoveAccountInfo(uint32 id);
 
-    DiscordAccountInfo const* GetAccountInfo(uint32 id);
+    DiscordAccountInfoPtr GetAccountInfo(uint32 id);
+    std::vector<DiscordAccountInfoPtr> GetGuildAccounts(int64 guildID);
+    AccountStoreMemoryInfo GetMemoryUsage() const { return _accounts.GetMemoryUsage(); }
 
 private:
     QueryCallbackProcessor _queryProcessor;
-    std::unordered_map<uint32, DiscordAccountInfo> _accounts;
-    std::mutex _mutex;
+    std::mutex _queryProcessorLock;
+
+    // Separate lock, commit callbacks start queries
+    AsyncCallbackProcessor<TransactionCallback> _transactionProcessor;
+    std::mutex _transactionProcessorLock;
+    AccountStore _accounts;
 };
 
 #define sAccountMgr AccountMgr::instance()
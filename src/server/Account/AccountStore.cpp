@@ -0,0 +1,165 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AccountStore.h"
+#include "Util.h"
+
+bool AccountStore::Add(DiscordAccountInfo&& info)
+{
+    auto account = std::make_shared<DiscordAccountInfo const>(std::move(info));
+
+    std::lock_guard<std::mutex> guard(_writeLock);
+
+    if (GetByID(account->ID) || GetByName(account->Name))
+        return false;
+
+    Insert(account);
+    return true;
+}
+
+bool AccountStore::Update(DiscordAccountInfo&& info)
+{
+    auto account = std::make_shared<DiscordAccountInfo const>(std::move(info));
+
+    std::lock_guard<std::mutex> guard(_writeLock);
+
+    auto sameName = GetByName(account->Name);
+    if (sameName && sameName->ID != account->ID)
+        return false;
+
+    if (auto oldAccount = GetByID(account->ID))
+        Erase(oldAccount);
+
+    Insert(account);
+    return true;
+}
+
+bool AccountStore::Remove(uint32 id)
+{
+    std::lock_guard<std::mutex> guard(_writeLock);
+
+    auto account = GetByID(id);
+    if (!account)
+        return false;
+
+    Erase(account);
+    return true;
+}
+
+void AccountStore::Clear()
+{
+    std::lock_guard<std::mutex> guard(_writeLock);
+
+    _byID.Clear();
+    _byName.Clear();
+    _byGuild.Clear();
+}
+
+void AccountStore::Insert(DiscordAccountInfoPtr const& account)
+{
+    _byID.Write(account->ID, [&account](auto& map)
+    {
+        map.emplace(account->ID, account);
+    });
+
+    std::string foldedName = FoldName(account->Name);
+
+    _byName.Write(foldedName, [&account, &foldedName](auto& map)
+    {
+        map.emplace(std::move(foldedName), account);
+    });
+
+    _byGuild.Write(account->GuildID, [&account](auto& map)
+    {
+        map[account->GuildID].emplace_back(account);
+    });
+}
+
+void AccountStore::Erase(DiscordAccountInfoPtr const& account)
+{
+    _byID.Write(account->ID, [&account](auto& map)
+    {
+        map.erase(account->ID);
+    });
+
+    std::string foldedName = FoldName(account->Name);
+
+    _byName.Write(foldedName, [&account, &foldedName](auto& map)
+    {
+        map.erase(foldedName);
+    });
+
+    _byGuild.Write(account->GuildID, [&account](auto& map)
+    {
+        auto itr = map.find(account->GuildID);
+        if (itr == map.end())
+            return;
+
+        std::erase(itr->second, account);
+        if (itr->second.empty())
+            map.erase(itr);
+    });
+}
+
+DiscordAccountInfoPtr AccountStore::GetByID(uint32 id) const
+{
+    return _byID.Read(id, [](DiscordAccountInfoPtr const* account)
+    {
+        return account ? *account : nullptr;
+    });
+}
+
+DiscordAccountInfoPtr AccountStore::GetByName(std::string_view name) const
+{
+    return _byName.Read(FoldName(name), [](DiscordAccountInfoPtr const* account)
+    {
+        return account ? *account : nullptr;
+    });
+}
+
+std::vector<DiscordAccountInfoPtr> AccountStore::GetByGuild(int64 guildID) const
+{
+    return _byGuild.Read(guildID, [](std::vector<DiscordAccountInfoPtr> const* accounts)
+    {
+        return accounts ? *accounts : std::vector<DiscordAccountInfoPtr>{};
+    });
+}
+
+AccountStoreMemoryInfo AccountStore::GetMemoryUsage() const
+{
+    AccountStoreMemoryInfo info;
+    info.ByID = _byID.GetMemoryUsage();
+    info.ByName = _byName.GetMemoryUsage();
+    info.ByGuild = _byGuild.GetMemoryUsage();
+
+    // Records are shared by all indices, count them once
+    for (DiscordAccountInfoPtr const& account : _byID.GetValues())
+        info.Records += sizeof(DiscordAccountInfo) + account->Name.capacity() + account->RealmName.capacity();
+
+    return info;
+}
+
+std::string AccountStore::FoldName(std::string_view name)
+{
+    std::string foldedName{ name };
+
+    // Keep as is for invalid utf8, it's not equal to any valid name anyway
+    if (!Utf8ToUpperOnlyLatin(foldedName))
+        return std::string{ name };
+
+    return foldedName;
+}
@@ -0,0 +1,190 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ACCOUNT_STORE_H
+#define _ACCOUNT_STORE_H
+
+#include "Define.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct DiscordAccountInfo
+{
+    DiscordAccountInfo(uint32 id, std::string_view name, int64 guildID, std::string_view realmName) :
+        ID(id), Name(name), GuildID(guildID), RealmName(realmName) { }
+
+    uint32 ID{ 0 };
+    int64 GuildID{ 0 };
+    std::string Name;
+    std::string RealmName;
+};
+
+using DiscordAccountInfoPtr = std::shared_ptr<DiscordAccountInfo const>;
+
+struct AccountStoreMemoryInfo
+{
+    std::size_t Records{ 0 };
+    std::size_t ByID{ 0 };
+    std::size_t ByName{ 0 };
+    std::size_t ByGuild{ 0 };
+
+    inline std::size_t Total() const { return Records + ByID + ByName + ByGuild; }
+};
+
+namespace Warhead::Impl
+{
+    // Heap memory owned by a key or value of the store maps
+    template<typename T>
+    std::size_t GetHeapSize(T const& /*value*/) { return 0; }
+
+    inline std::size_t GetHeapSize(std::string const& value) { return value.capacity(); }
+
+    template<typename T>
+    std::size_t GetHeapSize(std::vector<T> const& value) { return value.capacity() * sizeof(T); }
+
+    // Hash map split in shards, each guarded by own lock
+    template<typename Key, typename Value, std::size_t Shards = 16>
+    class ShardedHashMap
+    {
+    public:
+        template<typename Func>
+        auto Read(Key const& key, Func&& func) const
+        {
+            Shard const& shard = GetShard(key);
+            std::shared_lock<std::shared_mutex> guard(shard.Lock);
+
+            auto itr = shard.Map.find(key);
+            return func(itr != shard.Map.end() ? &itr->second : nullptr);
+        }
+
+        template<typename Func>
+        auto Write(Key const& key, Func&& func)
+        {
+            Shard& shard = GetShard(key);
+            std::unique_lock<std::shared_mutex> guard(shard.Lock);
+            return func(shard.Map);
+        }
+
+        void Clear()
+        {
+            for (auto& shard : _shards)
+            {
+                std::unique_lock<std::shared_mutex> guard(shard.Lock);
+                shard.Map.clear();
+            }
+        }
+
+        std::size_t Size() const
+        {
+            std::size_t size{ 0 };
+
+            for (auto const& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> guard(shard.Lock);
+                size += shard.Map.size();
+            }
+
+            return size;
+        }
+
+        std::vector<Value> GetValues() const
+        {
+            std::vector<Value> values;
+
+            for (auto const& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> guard(shard.Lock);
+
+                for (auto const& [key, value] : shard.Map)
+                    values.emplace_back(value);
+            }
+
+            return values;
+        }
+
+        // Approximate, buckets, nodes and heap of keys and values. Objects behind pointers are not counted
+        std::size_t GetMemoryUsage() const
+        {
+            std::size_t memory{ sizeof(*this) };
+
+            for (auto const& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> guard(shard.Lock);
+                memory += shard.Map.bucket_count() * sizeof(void*);
+
+                for (auto const& [key, value] : shard.Map)
+                    memory += sizeof(void*) + sizeof(std::size_t) + sizeof(std::pair<Key const, Value>) + GetHeapSize(key) + GetHeapSize(value);
+            }
+
+            return memory;
+        }
+
+    private:
+        struct Shard
+        {
+            mutable std::shared_mutex Lock;
+            std::unordered_map<Key, Value> Map;
+        };
+
+        Shard& GetShard(Key const& key) { return _shards[std::hash<Key>{}(key) % Shards]; }
+        Shard const& GetShard(Key const& key) const { return _shards[std::hash<Key>{}(key) % Shards]; }
+
+        std::array<Shard, Shards> _shards;
+    };
+}
+
+// Accounts indexed by id, case folded name and guild id, safe for concurrent access.
+// Writers change all indices under one lock, readers only take the lock of one shard
+class WH_SERVER_API AccountStore
+{
+public:
+    // Fails without changes if id or name is used
+    bool Add(DiscordAccountInfo&& info);
+
+    // Replaces record with the same id or adds it. Fails without changes if name is used by another account
+    bool Update(DiscordAccountInfo&& info);
+
+    bool Remove(uint32 id);
+    void Clear();
+
+    DiscordAccountInfoPtr GetByID(uint32 id) const;
+    DiscordAccountInfoPtr GetByName(std::string_view name) const;
+    std::vector<DiscordAccountInfoPtr> GetByGuild(int64 guildID) const;
+
+    std::size_t Size() const { return _byID.Size(); }
+    AccountStoreMemoryInfo GetMemoryUsage() const;
+
+    static std::string FoldName(std::string_view name);
+
+private:
+    // Callers hold _writeLock
+    void Insert(DiscordAccountInfoPtr const& account);
+    void Erase(DiscordAccountInfoPtr const& account);
+
+    std::mutex _writeLock;
+    Warhead::Impl::ShardedHashMap<uint32, DiscordAccountInfoPtr> _byID;
+    Warhead::Impl::ShardedHashMap<std::string, DiscordAccountInfoPtr> _byName;
+    Warhead::Impl::ShardedHashMap<int64, std::vector<DiscordAccountInfoPtr>> _byGuild;
+};
+
+#endif
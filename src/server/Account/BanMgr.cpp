@@ -27,7 +27,17 @@
 #include "Timer.h"
 
 BanInfo::BanInfo(Seconds duration, Seconds banDate /*= 0s*/) :
-    Duration(duration), BanDate(banDate == 0s ? GameTime::GetGameTime() : banDate), UnabanDate(banDate + duration) { }
+    Duration(duration), BanDate(banDate == 0s ? GameTime::GetGameTime() : banDate), UnabanDate(BanDate + duration) { }
+
+bool BanInfo::IsActive() const
+{
+    return IsPermanently() || UnabanDate > GameTime::GetGameTime();
+}
+
+namespace
+{
+    constexpr Seconds EXPIRY_FLUSH_INTERVAL = 10s;
+}
 
 BanMgr* BanMgr::instance()
 {
@@ -39,11 +49,180 @@ void BanMgr::Initialize()
 {
     StopWatch sw;
 
+    // Bans expired while the server was offline
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_UPD_ACCOUNT_BAN_EXPIRED);
-    DiscordDatabase.Execute(stmt);
+    DiscordDatabase.Execute(stmt, SQLPriority::Bulk);
 
     stmt = DiscordDatabase.GetPreparedStatement(DISCORD_UPD_IP_BAN_EXPIRED);
-    DiscordDatabase.Execute(stmt);
+    DiscordDatabase.Execute(stmt, SQLPriority::Bulk);
+
+    {
+        std::lock_guard<std::mutex> guard(_expiryLock);
+        _expiryWheelTime = GameTime::GetGameTime();
+        _nextExpiryFlushTime = _expiryWheelTime + EXPIRY_FLUSH_INTERVAL;
+    }
+
+    LoadAccountBans();
+    LoadIpBans();
+
+    LOG_INFO("server.loading", ">> Loaded {} account bans and {} ip bans in {}", _storeAccount.size(), _storeIp.size(), sw);
+    LOG_INFO("server.loading", "");
+}
+
+void BanMgr::Update()
+{
+    Seconds now = GameTime::GetGameTime();
+
+    std::lock_guard<std::mutex> guard(_expiryLock);
+
+    if (_expiryWheelTime < now)
+    {
+        // Every slot is visited once per wheel turn
+        Seconds steps = std::min<Seconds>(now - _expiryWheelTime, Seconds(EXPIRY_WHEEL_SIZE));
+
+        for (Seconds i = 1s; i <= steps; ++i)
+            ProcessExpirySlot(_expiryWheel[(_expiryWheelTime + i).count() % EXPIRY_WHEEL_SIZE], now);
+
+        _expiryWheelTime = now;
+    }
+
+    if (_nextExpiryFlushTime <= now)
+    {
+        FlushExpired();
+        _nextExpiryFlushTime = now + EXPIRY_FLUSH_INTERVAL;
+    }
+}
+
+void BanMgr::ScheduleExpiry(BanExpiry&& expiry)
+{
+    std::lock_guard<std::mutex> guard(_expiryLock);
+
+    // Past unban dates are picked up on the next update
+    Seconds unbanDate = std::max(expiry.UnbanDate, _expiryWheelTime + 1s);
+    _expiryWheel[unbanDate.count() % EXPIRY_WHEEL_SIZE].emplace_back(std::move(expiry));
+}
+
+void BanMgr::ProcessExpirySlot(std::vector<BanExpiry>& slot, Seconds now)
+{
+    std::erase_if(slot, [this, now](BanExpiry const& expiry)
+    {
+        // Later wheel turn
+        if (expiry.UnbanDate > now)
+            return false;
+
+        if (expiry.AccountID)
+        {
+            std::unique_lock<std::shared_mutex> guard(_accountBansLock);
+
+            // Ban was removed or replaced
+            auto itr = _storeAccount.find(expiry.AccountID);
+            if (itr == _storeAccount.end() || itr->second.IsPermanently() || itr->second.UnabanDate != expiry.UnbanDate)
+                return true;
+
+            _storeAccount.erase(itr);
+            ++_expiredAccountBans;
+            LOG_DEBUG("ban.account", "> Ban for account {} expired", expiry.AccountID);
+            return true;
+        }
+
+        std::unique_lock<std::shared_mutex> guard(_ipBansLock);
+
+        auto itr = _storeIp.find(expiry.Ip);
+        if (itr == _storeIp.end() || itr->second.Info.IsPermanently() || itr->second.Info.UnabanDate != expiry.UnbanDate)
+            return true;
+
+        _storeIp.erase(itr);
+        ++_expiredIpBans;
+
+        if (auto network = Warhead::Net::MakeNetworkV6(expiry.Ip))
+            _ipBans.Remove(*network);
+
+        LOG_DEBUG("ban.account", "> Ban for ip {} expired", expiry.Ip);
+        return true;
+    });
+}
+
+void BanMgr::FlushExpired()
+{
+    if (!_expiredAccountBans && !_expiredIpBans)
+        return;
+
+    // One update deactivates every expired row
+    auto trans = DiscordDatabase.BeginTransaction();
+
+    if (_expiredAccountBans)
+        trans->Append(DiscordDatabase.GetPreparedStatement(DISCORD_UPD_ACCOUNT_BAN_EXPIRED));
+
+    if (_expiredIpBans)
+        trans->Append(DiscordDatabase.GetPreparedStatement(DISCORD_UPD_IP_BAN_EXPIRED));
+
+    DiscordDatabase.CommitTransaction(trans, SQLPriority::Bulk);
+
+    LOG_DEBUG("ban.account", "> Deactivated {} account bans and {} ip bans", _expiredAccountBans, _expiredIpBans);
+
+    _expiredAccountBans = 0;
+    _expiredIpBans = 0;
+}
+
+void BanMgr::LoadAccountBans()
+{
+    {
+        std::unique_lock<std::shared_mutex> guard(_accountBansLock);
+        _storeAccount.clear();
+    }
+
+    //                                                                      0      1          2
+    PreparedQueryResult result = DiscordDatabase.Query(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_ACCOUNT_BANS));
+    if (!result)
+        return;
+
+    do
+    {
+        auto const& [accountID, banDate, unbanDate] = result->FetchTuple<uint32, Seconds, Seconds>();
+        BanInfo banInfo(unbanDate - banDate, banDate);
+
+        // Keep the longest of several active bans
+        if (auto existBan = GetBanInfoAccount(accountID))
+            if (existBan->IsPermanently() || (!banInfo.IsPermanently() && existBan->UnabanDate >= banInfo.UnabanDate))
+                continue;
+
+        AddAccount(accountID, banInfo);
+    } while (result->NextRow());
+}
+
+void BanMgr::LoadIpBans()
+{
+    {
+        std::unique_lock<std::shared_mutex> guard(_ipBansLock);
+        _storeIp.clear();
+        _ipBans.Clear();
+    }
+
+    //                                                                 0      1          2
+    PreparedQueryResult result = DiscordDatabase.Query(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_IP_BANS));
+    if (!result)
+        return;
+
+    do
+    {
+        auto const& [ip, banDate, unbanDate] = result->FetchTuple<std::string, Seconds, Seconds>();
+        AddIp(ip, BanInfo(unbanDate - banDate, banDate));
+    } while (result->NextRow());
+}
+
+Optional<BanInfo> BanMgr::GetBanInfoAddress(boost::asio::ip::address const& address) const
+{
+    std::shared_lock<std::shared_mutex> guard(_ipBansLock);
+
+    BanInfo const* banInfo = _ipBans.Match(Warhead::Net::ToAddressV6(address), [](BanInfo const& banInfo)
+    {
+        return banInfo.IsActive();
+    });
+
+    if (!banInfo)
+        return std::nullopt;
+
+    return *banInfo;
 }
 
 BanResponceCode BanMgr::BanAccount(std::string_view accountName, Seconds duration, std::string_view reason)
@@ -55,11 +234,10 @@ BanResponceCode BanMgr::BanAccount(std::string_view accountName, Seconds duratio
     if (!accountID)
         return BanResponceCode::NotFound;
 
-    auto const& banInfo = GetBanInfoAccount(std::string(accountName));
-    if (banInfo && (banInfo->IsPermanently() || banInfo->UnabanDate > GameTime::GetGameTime()))
+    if (GetBanInfoAccount(accountID))
         return BanResponceCode::Exist;
 
-    DeleteAccount(std::string(accountName));
+    DeleteAccount(accountName);
 
     // No SQL injection with prepared statements
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_INS_ACCOUNT_BAN);
@@ -67,7 +245,7 @@ BanResponceCode BanMgr::BanAccount(std::string_view accountName, Seconds duratio
     stmt->SetData(1, duration);
     stmt->SetData(2, "Console");
     stmt->SetData(3, reason);
-    DiscordDatabase.Execute(stmt);
+    DiscordDatabase.ExecuteBatched(stmt);
 
     if (auto session = sDiscord->FindSession(accountID))
         session->KickSession("Ban Account");
@@ -78,100 +256,143 @@ BanResponceCode BanMgr::BanAccount(std::string_view accountName, Seconds duratio
 
     LOG_WARN("ban.account", "> Ban account '{}'. Reason '{}'. Duration {}", accountName, reason, durationString);
 
-    AddAccount(std::string(accountName), BanInfo(duration));
+    AddAccount(accountID, BanInfo(duration));
 
     return BanResponceCode::Ok;
 }
 
 BanResponceCode BanMgr::BanIp(std::string_view ip, Seconds duration, std::string_view reason)
 {
-    if (ip.empty())
+    auto network = Warhead::Net::MakeNetworkV6(ip);
+    if (!network)
         return BanResponceCode::Error;
 
-    auto const& banInfo = GetBanInfoIp(std::string(ip));
+    // Same network in any notation is one ban
+    std::string networkString = Warhead::Net::ToNetworkString(*network);
+
+    auto const& banInfo = GetBanInfoIp(networkString);
     if (banInfo && (banInfo->IsPermanently() || banInfo->UnabanDate > GameTime::GetGameTime()))
         return BanResponceCode::Exist;
 
-    DeleteIp(std::string(ip));
+    DeleteIp(networkString);
 
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_INS_IP_BAN);
-    stmt->SetData(0, ip);
+    stmt->SetData(0, networkString);
     stmt->SetData(1, duration);
     stmt->SetData(2, "Console");
     stmt->SetData(3, reason);
-    DiscordDatabase.Execute(stmt);
+    DiscordDatabase.ExecuteBatched(stmt);
 
-    for (auto const& [accountID, session] : sDiscord->GetAllSessions())
-    {
-        if (session->GetRemoteAddress() == ip)
-            session->KickSession("Ban IP");
-    }
+    sDiscord->KickSessionsInNetwork(*network, "Ban IP");
 
     std::string durationString = Warhead::Time::ToTimeString(duration);
     if (duration == 0s)
         durationString = "Permanently";
 
-    LOG_WARN("ban.account", "> Ban ip '{}'. Reason '{}'. Duration {}", ip, reason, durationString);
+    LOG_WARN("ban.account", "> Ban ip '{}'. Reason '{}'. Duration {}", networkString, reason, durationString);
 
-    AddIp(std::string(ip), BanInfo(duration));
+    AddIp(networkString, BanInfo(duration));
 
     return BanResponceCode::Ok;
 }
 
-BanInfo const* BanMgr::GetBanInfoAccount(std::string const& accountName)
+Optional<BanInfo> BanMgr::GetBanInfoAccount(uint32 accountID) const
 {
-    auto banInfo = Warhead::Containers::MapGetValuePtr(_storeAccount, accountName);
-    return banInfo ? banInfo->get() : nullptr;
+    std::shared_lock<std::shared_mutex> guard(_accountBansLock);
+
+    auto itr = _storeAccount.find(accountID);
+    if (itr == _storeAccount.end() || !itr->second.IsActive())
+        return std::nullopt;
+
+    return itr->second;
 }
 
-BanInfo const* BanMgr::GetBanInfoIp(std::string const& ip)
+Optional<BanInfo> BanMgr::GetBanInfoIp(std::string const& ip) const
 {
-    auto banInfo = Warhead::Containers::MapGetValuePtr(_storeIp, ip);
-    return banInfo ? banInfo->get() : nullptr;
+    auto network = Warhead::Net::MakeNetworkV6(ip);
+    if (!network)
+        return std::nullopt;
+
+    std::shared_lock<std::shared_mutex> guard(_ipBansLock);
+
+    auto ipBan = Warhead::Containers::MapGetValuePtr(_storeIp, Warhead::Net::ToNetworkString(*network));
+    if (!ipBan)
+        return std::nullopt;
+
+    return ipBan->Info;
 }
 
-void BanMgr::AddAccount(std::string const& accountName, BanInfo const& banType)
+void BanMgr::AddAccount(uint32 accountID, BanInfo const& banType)
 {
-    auto const& itr = _storeAccount.find(accountName);
-    if (itr != _storeAccount.end())
-        _storeAccount.erase(accountName);
+    {
+        std::unique_lock<std::shared_mutex> guard(_accountBansLock);
+        _storeAccount.insert_or_assign(accountID, banType);
+    }
 
-    _storeAccount.emplace(accountName, std::make_unique<BanInfo>(banType));
+    if (!banType.IsPermanently())
+        ScheduleExpiry({ banType.UnabanDate, accountID, {} });
 }
 
 void BanMgr::AddIp(std::string const& ip, BanInfo const& banType)
 {
-    auto const& itr = _storeIp.find(ip);
-    if (itr != _storeIp.end())
-        _storeIp.erase(ip);
+    auto network = Warhead::Net::MakeNetworkV6(ip);
+    if (!network)
+    {
+        LOG_ERROR("ban.account", "> Incorrect ip or network '{}' for ban", ip);
+        return;
+    }
+
+    std::string networkString = Warhead::Net::ToNetworkString(*network);
+
+    {
+        std::unique_lock<std::shared_mutex> guard(_ipBansLock);
+        _storeIp.insert_or_assign(networkString, IpBan(ip, banType));
+        _ipBans.Insert(*network, banType);
+    }
 
-    _storeIp.emplace(ip, std::make_unique<BanInfo>(banType));
+    if (!banType.IsPermanently())
+        ScheduleExpiry({ banType.UnabanDate, 0, std::move(networkString) });
 }
 
-void BanMgr::DeleteAccount(std::string const& accountName)
+void BanMgr::DeleteAccount(std::string_view accountName)
 {
-    if (!GetBanInfoAccount(accountName))
-        return;
-
     uint32 accountID = sAccountMgr->GetID(accountName);
     if (!accountID)
         return;
 
+    {
+        std::unique_lock<std::shared_mutex> guard(_accountBansLock);
+        if (!_storeAccount.erase(accountID))
+            return;
+    }
+
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_DEL_BAN_ACCOUNT);
     stmt->SetArguments(accountID);
-    DiscordDatabase.Execute(stmt);
-
-    _storeAccount.erase(accountName);
+    DiscordDatabase.ExecuteBatched(stmt);
 }
 
 void BanMgr::DeleteIp(std::string const& ip)
 {
-    if (!GetBanInfoIp(ip))
+    auto network = Warhead::Net::MakeNetworkV6(ip);
+    if (!network)
         return;
 
-    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_DEL_BAN_IP);
-    stmt->SetArguments(ip);
-    DiscordDatabase.Execute(stmt);
+    std::string dbIp;
 
-    _storeIp.erase(ip);
+    {
+        std::unique_lock<std::shared_mutex> guard(_ipBansLock);
+
+        auto itr = _storeIp.find(Warhead::Net::ToNetworkString(*network));
+        if (itr == _storeIp.end())
+            return;
+
+        // Row of a ban loaded from db may use another notation of the network
+        dbIp = std::move(itr->second.Ip);
+        _storeIp.erase(itr);
+        _ipBans.Remove(*network);
+    }
+
+    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_DEL_BAN_IP);
+    stmt->SetArguments(dbIp);
+    DiscordDatabase.ExecuteBatched(stmt);
 }
@@ -20,10 +20,16 @@
 
 #include "Define.h"
 #include "Duration.h"
+#include "IpNetworkTrie.h"
+#include "Optional.h"
+#include <array>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string_view>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 /// Ban function return codes
 enum class BanResponceCode : uint8
@@ -43,6 +49,7 @@ struct BanInfo
     Seconds UnabanDate;
 
     inline bool IsPermanently() const { return Duration == 0s || BanDate == UnabanDate; }
+    bool IsActive() const;
 };
 
 class WH_SERVER_API BanMgr
@@ -51,22 +58,72 @@ public:
     static BanMgr* instance();
 
     void Initialize();
+    void Update();
 
     BanResponceCode BanAccount(std::string_view accountName, Seconds duration, std::string_view reason);
     BanResponceCode BanIp(std::string_view ip, Seconds duration, std::string_view reason);
 
-    void DeleteAccount(std::string const& accountName);
+    void DeleteAccount(std::string_view accountName);
     void DeleteIp(std::string const& ip);
 
-    BanInfo const* GetBanInfoAccount(std::string const& accountName);
-    BanInfo const* GetBanInfoIp(std::string const& ip);
+    // Thread safe, returns only active bans
+    Optional<BanInfo> GetBanInfoAccount(uint32 accountID) const;
 
-    void AddAccount(std::string const& accountName, BanInfo const& banType);
+    // Thread safe, exact network in any notation
+    Optional<BanInfo> GetBanInfoIp(std::string const& ip) const;
+
+    void AddAccount(uint32 accountID, BanInfo const& banType);
     void AddIp(std::string const& ip, BanInfo const& banType);
 
+    // Thread safe, checks addresses and CIDR ranges, returns only active bans
+    Optional<BanInfo> GetBanInfoAddress(boost::asio::ip::address const& address) const;
+
 private:
-    std::unordered_map<std::string, std::unique_ptr<BanInfo>> _storeAccount;
-    std::unordered_map<std::string, std::unique_ptr<BanInfo>> _storeIp;
+    void LoadAccountBans();
+    void LoadIpBans();
+
+    // Expiry schedule, one slot per second of unban time
+    static constexpr std::size_t EXPIRY_WHEEL_SIZE = 1024;
+
+    struct BanExpiry
+    {
+        Seconds UnbanDate;
+        uint32 AccountID{ 0 };
+        std::string Ip;
+    };
+
+    // ScheduleExpiry takes _expiryLock, the others run under it from Update
+    void ScheduleExpiry(BanExpiry&& expiry);
+    void ProcessExpirySlot(std::vector<BanExpiry>& slot, Seconds now);
+    void FlushExpired();
+
+    std::unordered_map<uint32, BanInfo> _storeAccount;
+    mutable std::shared_mutex _accountBansLock;
+
+    struct IpBan
+    {
+        IpBan(std::string_view ip, BanInfo const& info) : Ip(ip), Info(info) { }
+
+        std::string Ip; // as stored in db
+        BanInfo Info;
+    };
+
+    // Canonical network string -> ban, any notation of the same network finds it
+    std::unordered_map<std::string, IpBan> _storeIp;
+
+    // Index of _storeIp for checks from network threads, both guarded by _ipBansLock
+    Warhead::Net::IpNetworkTrie<BanInfo> _ipBans;
+    mutable std::shared_mutex _ipBansLock;
+
+    // Taken before _accountBansLock and _ipBansLock, never while holding them
+    std::mutex _expiryLock;
+    std::array<std::vector<BanExpiry>, EXPIRY_WHEEL_SIZE> _expiryWheel;
+    Seconds _expiryWheelTime{ 0s };
+
+    // Expired bans are deactivated in db by one batch update
+    std::size_t _expiredAccountBans{ 0 };
+    std::size_t _expiredIpBans{ 0 };
+    Seconds _nextExpiryFlushTime{ 0s };
 };
 
 #define sBanMgr BanMgr::instance()
@@ -108,6 +108,27 @@ namespace
             return "";
         }
     }
+
+    dpp::command_completion_event_t GetMessageCompletion(CompleteFunction&& complete)
+    {
+        return [complete = std::move(complete)](dpp::confirmation_callback_t const& callback)
+        {
+            if (callback.is_error())
+                LOG_ERROR("discord", "> Error at send message: {}", callback.get_error().message);
+
+            if (complete)
+                complete(!callback.is_error());
+        };
+    }
+
+    // dpp REST call for co_await. Callback comes from dpp thread, awaiting coroutine is resumed on its own executor
+    Warhead::Async::CallbackAwaiter<dpp::confirmation_callback_t> AwaitRest(std::function<void(dpp::command_completion_event_t&&)>&& call)
+    {
+        return Warhead::Async::CallbackAwaiter<dpp::confirmation_callback_t>([call = std::move(call)](std::function<void(dpp::confirmation_callback_t)>&& complete)
+        {
+            call([complete = std::move(complete)](dpp::confirmation_callback_t const& result) { complete(result); });
+        });
+    }
 }
 
 DiscordBot* DiscordBot::instance()
@@ -206,24 +227,52 @@ void DiscordBot::CheckClients()
     });
 }
 
-void DiscordBot::SendDefaultMessage(int64 channelID, std::string_view message)
+void DiscordBot::SendDefaultMessage(int64 channelID, std::string_view message, CompleteFunction&& complete /*= nullptr*/)
 {
     if (!_isEnable)
+    {
+        if (complete)
+            complete(false);
+
         return;
+    }
 
     dpp::message discordMessage;
     discordMessage.channel_id = channelID;
     discordMessage.content = std::string(message);
 
-    _bot->message_create(discordMessage);
+    _bot->message_create(discordMessage, GetMessageCompletion(std::move(complete)));
 }
 
-void DiscordBot::SendEmbedMessage(int64 channelID, std::shared_ptr<dpp::embed> embed)
+void DiscordBot::SendEmbedMessage(int64 channelID, std::shared_ptr<dpp::embed> embed, CompleteFunction&& complete /*= nullptr*/)
 {
     if (!_isEnable || !embed)
+    {
+        if (complete)
+            complete(false);
+
         return;
+    }
+
+    _bot->message_create(dpp::message(channelID, *embed), GetMessageCompletion(std::move(complete)));
+}
+
+std::shared_ptr<std::atomic<uint32>> DiscordBot::GetOutboundQueue(int64 guildID)
+{
+    auto& queue = _outboundQueues[guildID];
+    if (!queue)
+        queue = std::make_shared<std::atomic<uint32>>(0);
 
-    _bot->message_create(dpp::message(channelID, *embed));
+    return queue;
+}
+
+uint32 DiscordBot::GetOutboundQueueSize(int64 guildID) const
+{
+    auto const& itr = _outboundQueues.find(guildID);
+    if (itr == _outboundQueues.end())
+        return 0;
+
+    return itr->second->load();
 }
 
 void DiscordBot::ConfigureLogs()
@@ -493,193 +542,179 @@ void DiscordBot::LoadClients()
 
     LOG_INFO("discord", "Loading clients...");
 
-    QueryResult result = DiscordDatabase.Query("SELECT `GuildID`, `GuildName`, `MembersCount`, UNIX_TIMESTAMP(`InviteDate`) FROM clients");
-    if (!result)
+    uint64 rows = DiscordDatabase.QueryStream(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_CLIENTS), [this](PreparedResultSet const& chunk)
+    {
+        for (auto const& [guildID, guildName, membersCount, inviteDate] : chunk.Rows<int64, std::string_view, uint32, int64>())
+            _guilds.emplace(guildID, DiscordClients(guildID, guildName, membersCount, Seconds(inviteDate)));
+    });
+
+    if (!rows)
     {
         LOG_WARN("sql.sql", ">> Loaded 0 clients. DB table `clients` is empty.");
         LOG_INFO("discord", "");
         return;
     }
 
-    do
-    {
-        auto const& [guildID, guildName, membersCount, inviteDate] = result->FetchTuple<int64, std::string_view, uint32, Seconds>();
-        
-        _guilds.emplace(guildID, DiscordClients(guildID, guildName, membersCount, inviteDate));
-
-    } while (result->NextRow());
-
     LOG_INFO("discord", ">> Loaded {} clients in {}", _guilds.size(), sw);
     LOG_INFO("discord", "");
 }
 
-void DiscordBot::CheckBotInGuild(int64 guildID, CompleteFunction&& execute)
+Warhead::Async::Task<bool> DiscordBot::CheckBotInGuild(int64 guildID)
 {
-    sAsyncCallbackMgr->AddAsyncCallback([this, guildID, execute = std::move(execute)]()
+    LOG_DEBUG("discord", "> Start check guild {} in bot", guildID);
+
+    auto result = co_await AwaitRest([this](dpp::command_completion_event_t&& complete)
     {
-        LOG_DEBUG("discord", "> Start check guild {} in bot", guildID);
+        _bot->current_user_get_guilds(std::move(complete));
+    });
 
-        auto const& guilds = _bot->current_user_get_guilds_sync();
-        if (guilds.empty())
-        {
-            execute(false);
-            LOG_FATAL("discord", "> Empty guilds in bot. What?");
-            return;
-        }
+    if (result.is_error())
+    {
+        LOG_ERROR("discord", "DiscordBot::CheckBotInGuild: Error at get guilds: {}", result.get_error().message);
+        co_return false;
+    }
 
-        if (guilds.find(guildID) == guilds.end())
-        {
-            execute(false);
-            LOG_ERROR("discord", "> Not found guild {} in bot", guildID);
-            return;
-        }
+    auto const& guilds = std::get<dpp::guild_map>(result.value);
+    if (guilds.empty())
+    {
+        LOG_FATAL("discord", "> Empty guilds in bot. What?");
+        co_return false;
+    }
+
+    if (guilds.find(guildID) == guilds.end())
+    {
+        LOG_ERROR("discord", "> Not found guild {} in bot", guildID);
+        co_return false;
+    }
 
-        execute(true);
-        LOG_DEBUG("discord", "> Founded guild {} in bot", guildID);
-    }, 1s);
+    LOG_DEBUG("discord", "> Founded guild {} in bot", guildID);
+    co_return true;
 }
 
-void DiscordBot::CheckChannels(int64 guildID, CompleteChannelFunction&& execute)
+Warhead::Async::Task<int64> DiscordBot::CreateChannel(int64 guildID, std::string_view name, uint16 flags, int64 parentID /*= 0*/)
 {
-    sAsyncCallbackMgr->AddAsyncCallback([this, guildID, execute = std::move(execute)]()
+    dpp::channel channelToCreate;
+    channelToCreate.set_guild_id(guildID);
+    channelToCreate.set_name(std::string(name));
+    channelToCreate.set_flags(flags);
+
+    if (parentID)
+        channelToCreate.set_parent_id(parentID);
+
+    auto result = co_await AwaitRest([this, &channelToCreate](dpp::command_completion_event_t&& complete)
     {
-        LOG_DEBUG("discord", "> Start check channels for guild id: {}", guildID);
+        _bot->channel_create(channelToCreate, std::move(complete));
+    });
 
-        auto GetCategory = [this](dpp::channel_map const& channels) -> int64
-        {
-            for (auto const& [channelID, channel] : channels)
-            {
-                if (!channel.is_category())
-                    continue;
+    if (result.is_error())
+    {
+        LOG_ERROR("discord", "DiscordBot::CreateChannel: Error at create channel '{}': {}", name, result.get_error().message);
+        co_return 0;
+    }
 
-                if (channel.name == DEFAULT_CATEGORY_NAME)
-                {
-                    LOG_DEBUG("discord", "> Category with name '{}' exist. ID {}", DEFAULT_CATEGORY_NAME, channelID);
-                    return channelID;
-                }
-            }
+    co_return int64(std::get<dpp::channel>(result.value).id);
+}
 
-            return 0;
-        };
+Warhead::Async::Task<DiscordChannelsList> DiscordBot::CheckChannels(int64 guildID)
+{
+    LOG_DEBUG("discord", "> Start check channels for guild id: {}", guildID);
 
-        auto CreateCategory = [this, guildID]() -> int64
+    auto GetCategory = [](dpp::channel_map const& channels) -> int64
+    {
+        for (auto const& [channelID, channel] : channels)
         {
-            try
-            {
-                dpp::channel categoryToCreate;
-                categoryToCreate.set_guild_id(guildID);
-                categoryToCreate.set_name(DEFAULT_CATEGORY_NAME);
-                categoryToCreate.set_flags(dpp::CHANNEL_CATEGORY);
+            if (!channel.is_category())
+                continue;
 
-                auto createdCategory = _bot->channel_create_sync(categoryToCreate);
-                return createdCategory.id;
-            }
-            catch (dpp::rest_exception const& error)
+            if (channel.name == DEFAULT_CATEGORY_NAME)
             {
-                LOG_ERROR("discord", "DiscordBot::CheckChannels: Error at create category: {}", error.what());
-                return 0;
+                LOG_DEBUG("discord", "> Category with name '{}' exist. ID {}", DEFAULT_CATEGORY_NAME, channelID);
+                return channelID;
             }
+        }
 
-            return 0;
-        };
+        return 0;
+    };
 
-        auto GetTextChannels = [this](dpp::channel_map const& channels, int64 findCategoryID, DiscordChannelsList& channelList)
+    auto GetTextChannels = [](dpp::channel_map const& channels, int64 findCategoryID, DiscordChannelsList& channelList)
+    {
+        for (auto const& [channelID, channel] : channels)
         {
-            for (auto const& [channelID, channel] : channels)
-            {
-                if (!channel.is_text_channel() || channel.parent_id != findCategoryID)
-                    continue;
+            if (!channel.is_text_channel() || channel.parent_id != findCategoryID)
+                continue;
 
-                auto channelType = GetDiscordChannelType(channel.name);
-                if (channelType == DiscordChannelType::MaxType)
-                    continue;
+            auto channelType = GetDiscordChannelType(channel.name);
+            if (channelType == DiscordChannelType::MaxType)
+                continue;
 
-                channelList[static_cast<std::size_t>(channelType)] = channelID;
-            }
-        };
+            channelList[static_cast<std::size_t>(channelType)] = channelID;
+        }
+    };
 
-        auto CreateTextChannel = [this, guildID](DiscordChannelsList& channelList, int64 findCategoryID)
-        {
-            for (size_t i = 0; i < DEFAULT_CHANNELS_COUNT; i++)
-            {
-                auto& channelID = channelList[i];
-                if (!channelID)
-                {
-                    auto channelName = GetChannelName(static_cast<DiscordChannelType>(i));
-                    if (channelName.empty())
-                    {
-                        LOG_ERROR("discord", "> Empty get channel name for type {}", i);
-                        continue;
-                    }
-
-                    try
-                    {
-                        dpp::channel channelToCreate;
-                        channelToCreate.set_guild_id(guildID);
-                        channelToCreate.set_name(channelName);
-                        channelToCreate.set_flags(dpp::CHANNEL_TEXT);
-                        channelToCreate.set_parent_id(findCategoryID);
-
-                        auto createdChannel = _bot->channel_create_sync(channelToCreate);
-                        channelID = createdChannel.id;
-                        LOG_INFO("discord", "> Created channel {}. ID {}", channelName, createdChannel.id);
-                    }
-                    catch (dpp::rest_exception const& error)
-                    {
-                        LOG_ERROR("discord", "DiscordBot::CheckChannels: Error at create text channel: {}", error.what());
-                        continue;
-                    }
-                }
-            }
-        };
+    DiscordChannelsList channelsList{};
 
-        DiscordChannelsList channelsList;
+    auto result = co_await AwaitRest([this, guildID](dpp::command_completion_event_t&& complete)
+    {
+        _bot->channels_get(guildID, std::move(complete));
+    });
 
-        try
-        {
-            int64 findCategoryID{ 0 };
+    if (result.is_error())
+    {
+        LOG_ERROR("discord", "DiscordBot::CheckChannels: Error at check channels: {}", result.get_error().message);
+        co_return channelsList;
+    }
 
-            auto const& channels = _bot->channels_get_sync(guildID);
-            if (channels.empty())
-            {
-                LOG_FATAL("discord", "> Empty channels in guild. Guild is new?");
-                findCategoryID = CreateCategory();
-            }
+    auto const& channels = std::get<dpp::channel_map>(result.value);
+    int64 findCategoryID{ 0 };
 
-            // Exist any channel
-            if (!findCategoryID)
-                findCategoryID = GetCategory(channels);
+    if (channels.empty())
+    {
+        LOG_FATAL("discord", "> Empty channels in guild. Guild is new?");
+        findCategoryID = co_await CreateChannel(guildID, DEFAULT_CATEGORY_NAME, dpp::CHANNEL_CATEGORY);
+    }
 
-            // Not found DEFAULT_CATEGORY_NAME
-            if (!findCategoryID)
-            {
-                LOG_ERROR("discord", "> Category with name '{}' not found. Start creating", DEFAULT_CATEGORY_NAME);
-                findCategoryID = CreateCategory();
+    // Exist any channel
+    if (!findCategoryID)
+        findCategoryID = GetCategory(channels);
 
-                if (findCategoryID)
-                    LOG_INFO("discord", "> Category with name '{}' created. ID: {}", DEFAULT_CATEGORY_NAME, findCategoryID);
-                else
-                {
-                    LOG_INFO("discord", "> Error after create category with name '{}'", DEFAULT_CATEGORY_NAME);
-                    execute(std::move(channelsList));
-                    return;
-                }
-            }
+    // Not found DEFAULT_CATEGORY_NAME
+    if (!findCategoryID)
+    {
+        LOG_ERROR("discord", "> Category with name '{}' not found. Start creating", DEFAULT_CATEGORY_NAME);
+        findCategoryID = co_await CreateChannel(guildID, DEFAULT_CATEGORY_NAME, dpp::CHANNEL_CATEGORY);
 
-            // Exist DEFAULT_CATEGORY_NAME
-            GetTextChannels(channels, findCategoryID, channelsList);
-            CreateTextChannel(channelsList, findCategoryID);
+        if (!findCategoryID)
+        {
+            LOG_INFO("discord", "> Error after create category with name '{}'", DEFAULT_CATEGORY_NAME);
+            co_return channelsList;
         }
-        catch (dpp::rest_exception const& error)
+
+        LOG_INFO("discord", "> Category with name '{}' created. ID: {}", DEFAULT_CATEGORY_NAME, findCategoryID);
+    }
+
+    // Exist DEFAULT_CATEGORY_NAME
+    GetTextChannels(channels, findCategoryID, channelsList);
+
+    for (std::size_t i = 0; i < DEFAULT_CHANNELS_COUNT; i++)
+    {
+        auto& channelID = channelsList[i];
+        if (channelID)
+            continue;
+
+        auto channelName = GetChannelName(static_cast<DiscordChannelType>(i));
+        if (channelName.empty())
         {
-            LOG_ERROR("discord", "DiscordBot::CheckChannels: Error at check channels: {}", error.what());
-            execute(std::move(channelsList));
-            return;
+            LOG_ERROR("discord", "> Empty get channel name for type {}", i);
+            continue;
         }
 
-        LOG_DEBUG("discord", "> Founded {} text channels in guild", channelsList.size());
-        execute(std::move(channelsList));
-    });
+        channelID = co_await CreateChannel(guildID, channelName, dpp::CHANNEL_TEXT, findCategoryID);
+        if (channelID)
+            LOG_INFO("discord", "> Created channel {}. ID {}", channelName, channelID);
+    }
+
+    LOG_DEBUG("discord", "> Founded {} text channels in guild", channelsList.size());
+    co_return channelsList;
 }
 
 void DiscordBot::Test()
@@ -792,7 +827,7 @@ void DiscordBot::AddClient(int64 guildID, std::string_view guildName, uint32 mem
     // Add to DB
     auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_INS_CLIENT);
     stmt->SetArguments(guildID, guildName, membersCount, inviteDate.count(), atStartup ? 1 : 0);
-    DiscordDatabase.Execute(stmt);
+    DiscordDatabase.ExecuteBatched(stmt);
 }
 
 void DiscordBot::DeleteClient(int64 guildID)
@@ -807,7 +842,9 @@ void DiscordBot::DeleteClient(int64 guildID)
     _guilds.erase(guildID);
 
     // Delete from DB table
-    DiscordDatabase.Execute("DELETE FROM `clients` WHERE `GuildID` = {}", guildID);
+    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_DEL_CLIENT);
+    stmt->SetArguments(guildID);
+    DiscordDatabase.ExecuteBatched(stmt);
 }
 
 void DiscordBot::DeleteAllClients()
@@ -815,8 +852,9 @@ void DiscordBot::DeleteAllClients()
     // Clear core cache
     _guilds.clear();
 
-    // Clear DB table
-    DiscordDatabase.Execute("TRUNCATE `clients`");
+    // Clear DB table after the pending client rows, on the write-behind connection
+    DiscordDatabase.FlushBatched(true);
+    DiscordDatabase.ExecuteOrdered(WRITE_BEHIND_ORDER_KEY, "TRUNCATE `clients`");
 }
 
 void DiscordBot::LogAddClient(int64 guildID, DiscordMessageColor color, std::string_view icon, std::string_view guildName, uint32 membersCount, double creationDate)
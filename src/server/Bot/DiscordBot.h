@@ -18,15 +18,16 @@
 #ifndef _DISCORD_BOT_H_
 #define _DISCORD_BOT_H_
 
+#include "Coroutine.h"
 #include "Define.h"
 #include "DiscordSharedDefines.h"
 #include "Duration.h"
+#include <atomic>
 #include <memory>
 #include <functional>
 #include <unordered_map>
 
 using CompleteFunction = std::function<void(bool)>;
-using CompleteChannelFunction = std::function<void(DiscordChannelsList&&)>;
 
 namespace dpp
 {
@@ -63,16 +64,22 @@ class WH_SERVER_API DiscordBot
 public:
     static DiscordBot* instance();
 
-    void SendDefaultMessage(int64 channelID, std::string_view message);
-    void SendEmbedMessage(int64 channelID, std::shared_ptr<dpp::embed> embed);
+    // complete is called from dpp thread after Discord confirmed or rejected message
+    void SendDefaultMessage(int64 channelID, std::string_view message, CompleteFunction&& complete = nullptr);
+    void SendEmbedMessage(int64 channelID, std::shared_ptr<dpp::embed> embed, CompleteFunction&& complete = nullptr);
+
+    // Guild outbound queue, messages sent and not yet confirmed by Discord.
+    // Map is used only from world thread, counters are decreased from dpp threads
+    std::shared_ptr<std::atomic<uint32>> GetOutboundQueue(int64 guildID);
+    uint32 GetOutboundQueueSize(int64 guildID) const;
 
     void Start();
     void Test();
     void Update(Milliseconds diff);
 
-    // Guid check
-    void CheckBotInGuild(int64 guildID, CompleteFunction&& execute);
-    void CheckChannels(int64 guildID, CompleteChannelFunction&& channelList);
+    // Guid check, coroutines are resumed on executor of the awaiting side
+    Warhead::Async::Task<bool> CheckBotInGuild(int64 guildID);
+    Warhead::Async::Task<DiscordChannelsList> CheckChannels(int64 guildID);
 
 private:
     void ConfigureLogs();
@@ -83,6 +90,7 @@ private:
 
     // For guild
     void CreateCommands(int64 guildID);
+    Warhead::Async::Task<int64> CreateChannel(int64 guildID, std::string_view name, uint16 flags, int64 parentID = 0);
 
     // Clients cache
     bool HasClient(int64 guildID);
@@ -104,6 +112,7 @@ private:
     std::unique_ptr<TaskScheduler> _scheduler;
 
     std::unordered_map<int64, DiscordClients> _guilds;
+    std::unordered_map<int64, std::shared_ptr<std::atomic<uint32>>> _outboundQueues;
     std::vector<std::string> _commands;
 };
 
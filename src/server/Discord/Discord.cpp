@@ -16,19 +16,27 @@
  */
 
 #include "Discord.h"
-#include "AsyncCallbackMgr.h"
+#include "AccountAuthCache.h"
 #include "AccountMgr.h"
+#include "AsyncCallbackMgr.h"
+#include "BanMgr.h"
 #include "DatabaseEnv.h"
+#include "DatabaseStatistics.h"
+#include "DatabaseWorkQueue.h"
 #include "DiscordBot.h"
 #include "DiscordConfig.h"
 #include "DiscordSession.h"
 #include "DiscordSharedDefines.h"
+#include "DiscordSocketMgr.h"
 #include "Errors.h"
+#include "EventTemplateMgr.h"
 #include "GameTime.h"
+#include "IpNetwork.h"
 #include "Log.h"
 #include "Opcodes.h"
 #include "StopWatch.h"
 #include "UpdateTime.h"
+#include <algorithm>
 #include <boost/asio/ip/address.hpp>
 
 std::atomic<bool> Discord::_stopEvent = false;
@@ -53,6 +61,7 @@ Discord::~Discord()
         delete session;
 
     _sessions.clear();
+    _sessionsByAddress.clear();
 }
 
 /*static*/ Discord* Discord::instance()
@@ -91,6 +100,39 @@ void Discord::KickSession(uint32 id)
         itr->second->KickSession("KickSession", false);
 }
 
+void Discord::KickSessionsInNetwork(boost::asio::ip::network_v6 const& network, std::string_view reason)
+{
+    // Last address of network, all host bits set
+    auto lastBytes = network.network().to_bytes();
+    for (uint16 bit = network.prefix_length(); bit < 128; ++bit)
+        lastBytes[bit / 8] |= uint8(1 << (7 - bit % 8));
+
+    auto itr = _sessionsByAddress.lower_bound(network.network());
+    auto end = _sessionsByAddress.upper_bound(boost::asio::ip::address_v6(lastBytes));
+
+    for (; itr != end; ++itr)
+        for (uint32 accountID : itr->second)
+            if (auto session = FindSession(accountID))
+                session->KickSession(reason);
+}
+
+void Discord::AddSessionAddress(DiscordSession* session)
+{
+    _sessionsByAddress[Warhead::Net::ToAddressV6(session->GetRemoteIpAddress())].emplace(session->GetAccountId());
+}
+
+void Discord::RemoveSessionAddress(DiscordSession* session)
+{
+    auto const& itr = _sessionsByAddress.find(Warhead::Net::ToAddressV6(session->GetRemoteIpAddress()));
+    if (itr == _sessionsByAddress.end())
+        return;
+
+    itr->second.erase(session->GetAccountId());
+
+    if (itr->second.empty())
+        _sessionsByAddress.erase(itr);
+}
+
 void Discord::AddSession(DiscordSession* session)
 {
     ASSERT(session);
@@ -102,11 +144,13 @@ void Discord::AddSession(DiscordSession* session)
     auto const& old = _sessions.find(session->GetAccountId());
     if (old != _sessions.end())
     {
+        RemoveSessionAddress(old->second);
         delete old->second;
         _sessions.erase(session->GetAccountId());
     }
 
     _sessions.emplace(session->GetAccountId(), session);
+    AddSessionAddress(session);
     UpdateMaxSessionCounters();
     session->SendAuthResponse(DiscordAuthResponseCodes::Ok);    
 }
@@ -142,10 +186,38 @@ void Discord::SetInitialDiscordSettings()
     {
         LOG_INFO("time.diff", "> Update time diff. Last {} ms, Avg {} ms. Online {} sessions",
             sDiscordUpdateTime.GetLastUpdateTime().count(), sDiscordUpdateTime.GetAverageUpdateTime().count(), GetActiveSessionCount());
+
+        LOG_INFO("network", "> Sockets closed by timeout. Handshake {}, auth {}, ping {}, pending auth slot {}",
+            sDiscordSocketMgr.GetReapedSocketsCount(SocketTimeoutReason::Handshake), sDiscordSocketMgr.GetReapedSocketsCount(SocketTimeoutReason::Auth),
+            sDiscordSocketMgr.GetReapedSocketsCount(SocketTimeoutReason::Ping), sDiscordSocketMgr.GetReapedPendingSocketsCount());
+
+        LOG_INFO("network", "> Account auth cache. Hits {}, misses {}", sAccountAuthCache->GetHits(), sAccountAuthCache->GetMisses());
+
+        for (auto const& [priority, name] : { std::pair{ SQLPriority::Interactive, "interactive" }, std::pair{ SQLPriority::Normal, "normal" }, std::pair{ SQLPriority::Bulk, "bulk" } })
+        {
+            DatabaseQueueStats stats = DiscordDatabase.CollectQueueStats(priority);
+            LOG_INFO("sql.driver", "> Discord database {} queue. Depth {}, executed {}, wait avg {} us, max {} us",
+                name, stats.Depth, stats.Executed, stats.AvgWait.count(), stats.MaxWait.count());
+        }
+
+        LogDatabaseStatementStats();
+
         context.Repeat(5min);
     });
 
+    _scheduler.Schedule(1s, [this](TaskContext context)
+    {
+        for (auto const& [accountID, session] : _sessions)
+            session->UpdateThrottle();
+
+        sDiscordSocketMgr.RemoveExpiredPendingSockets();
+
+        context.Repeat();
+    });
+
     sAccountMgr->Initialize();
+    sBanMgr->Initialize();
+    sEventTemplateMgr->LoadTemplates();
 
     // Start discord bot
     sDiscordBot->Start();
@@ -157,6 +229,39 @@ void Discord::SetInitialDiscordSettings()
     LOG_INFO("server.loading", " ");
 }
 
+void Discord::LogDatabaseStatementStats()
+{
+    DatabaseStatementStats total = DiscordDatabase.CollectTotalStatementStats();
+    DatabaseLatencyStats const& execute = total.Get(SQLStage::Execute);
+
+    LOG_INFO("sql.driver", "> Discord database statements. Executed {}, errors {}, exec p50 {} us, p99 {} us, max {} us",
+        execute.Count, total.Errors, execute.P50.count(), execute.P99.count(), execute.Max.count());
+
+    // Statements which took the most execution time first
+    auto statements = DiscordDatabase.CollectStatementStats();
+    std::sort(statements.begin(), statements.end(), [](DatabaseStatementStats const& left, DatabaseStatementStats const& right)
+    {
+        auto totalTime = [](DatabaseStatementStats const& stats) { return stats.Get(SQLStage::Execute).Avg * stats.Get(SQLStage::Execute).Count; };
+        return totalTime(left) > totalTime(right);
+    });
+
+    if (statements.size() > 5)
+        statements.resize(5);
+
+    for (auto const& stats : statements)
+    {
+        LOG_INFO("sql.driver", ">> Statement {}: count {}, errors {}, wait p99 {} us, exec avg {} us, p99 {} us, decode p99 {} us. {}",
+            stats.Index, stats.Get(SQLStage::Execute).Count, stats.Errors, stats.Get(SQLStage::QueueWait).P99.count(),
+            stats.Get(SQLStage::Execute).Avg.count(), stats.Get(SQLStage::Execute).P99.count(), stats.Get(SQLStage::Decode).P99.count(), stats.Query);
+    }
+
+    for (auto const& slow : DiscordDatabase.CollectSlowStatements())
+    {
+        LOG_WARN("sql.driver", ">> Slow statement {} at {}: {}. {}", slow.Index,
+            Warhead::Time::TimeToTimestampStr(std::chrono::duration_cast<Seconds>(slow.Time.time_since_epoch())), Warhead::Time::ToTimeString(slow.Elapsed), slow.Query);
+    }
+}
+
 void Discord::Update(Milliseconds diff)
 {
     ///- Update the game time and check for shutdown time
@@ -173,8 +278,11 @@ void Discord::Update(Milliseconds diff)
     }
 
     sAccountMgr->Update();
+    sBanMgr->Update();
     sDiscordBot->Update(diff);
 
+    DiscordDatabase.FlushBatched();
+
     _scheduler.Update(diff);
 }
 
@@ -185,6 +293,7 @@ void Discord::KickAll()
         session->KickSession("KickAll sessions");
 
     _sessions.clear();
+    _sessionsByAddress.clear();
 }
 
 /// Update the game time
@@ -287,6 +396,7 @@ void Discord::UpdateSessions()
 
         if (!session->Update())
         {
+            RemoveSessionAddress(session);
             _sessions.erase(itr->first);
             delete session;
         }
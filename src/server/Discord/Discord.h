@@ -24,7 +24,10 @@
 #include "TaskScheduler.h"
 #include "Timer.h"
 #include <atomic>
+#include <boost/asio/ip/network_v6.hpp>
+#include <map>
 #include <unordered_map>
+#include <unordered_set>
 
 class DiscordPacket;
 class DiscordSocket;
@@ -53,6 +56,9 @@ public:
     void AddSession(DiscordSession* session);
     void KickSession(uint32 id);
 
+    // Kick sessions by remote address without scan of all sessions. IPv4 as v4-mapped network
+    void KickSessionsInNetwork(boost::asio::ip::network_v6 const& network, std::string_view reason);
+
     /// Get the number of current active sessions
     void UpdateMaxSessionCounters();
     [[nodiscard]] const auto& GetAllSessions() const { return _sessions; }
@@ -97,6 +103,10 @@ public:
 
 private:
     void _UpdateGameTime();
+    void LogDatabaseStatementStats();
+
+    void AddSessionAddress(DiscordSession* session);
+    void RemoveSessionAddress(DiscordSession* session);
 
     static std::atomic<bool> _stopEvent;
     static uint8 _exitCode;
@@ -105,6 +115,7 @@ private:
     bool m_isClosed;
 
     std::unordered_map<uint32, DiscordSession*> _sessions;
+    std::map<boost::asio::ip::address_v6, std::unordered_set<uint32>> _sessionsByAddress; // ordered for CIDR ranges
     std::size_t m_maxActiveSessionCount;
     uint32 _sessionCount;
     uint32 _maxSessionCount;
@@ -20,12 +20,19 @@
 #include "DiscordSession.h"
 #include "Log.h"
 #include "Opcodes.h"
+#include "ResumeTokenMgr.h"
 #include "SmartEnum.h"
+#include "StringDictionary.h"
 
 void DiscordSession::SendAuthResponse(DiscordAuthResponseCodes code)
 {
     DiscordPackets::Auth::AuthResponse authResponse;
     authResponse.Code = code;
+    authResponse.StringDictionarySize = _stringDictionary ? _stringDictionary->GetCapacity() : 0;
+    authResponse.MessageAckWindow = _messageAckWindow;
+
+    if (code == DiscordAuthResponseCodes::Ok)
+        authResponse.ResumeToken = sResumeTokenMgr->CreateToken({ _accountId, _guildID, _accountName, _channels });
 
     LOG_INFO("discord", "> Send responce code '{}'", EnumUtils::ToTitle(code));
 
@@ -18,29 +18,44 @@
 #include "Define.h"
 #include "DiscordBot.h"
 #include "DiscordSession.h"
+#include "EventTemplateMgr.h"
 #include "Log.h"
 #include "MessagePackets.h"
 #include <dpp/dpp.h>
 
 void DiscordSession::HandleSendDiscordMessageOpcode(DiscordPackets::Message::SendDiscordMessage& packet)
 {
+    if (!CheckMessageSequence(packet.Sequence))
+        return;
+
     auto channelID = GetChannelID(packet.ChannelType);
     if (!channelID)
+    {
+        CompleteMessage(packet.Sequence, false);
         return;
+    }
 
-    sDiscordBot->SendDefaultMessage(channelID, packet.Context);
+    sDiscordBot->SendDefaultMessage(channelID, packet.Context, GetMessageCompleteHandler(packet.Sequence));
 }
 
 void DiscordSession::HandleSendDiscordEmbedMessageOpcode(DiscordPackets::Message::SendDiscordEmbedMessage& packet)
 {
+    if (!CheckMessageSequence(packet.Sequence))
+        return;
+
     auto channelID = GetChannelID(packet.ChannelType);
     if (!channelID)
+    {
+        CompleteMessage(packet.Sequence, false);
         return;
+    }
 
+    // Packet strings are views into the packet buffer, the embed takes its own copy of each one
     auto embed = std::make_shared<dpp::embed>();
     embed->set_color(packet.Color);
-    embed->set_title(packet.Title);
-    embed->set_description(packet.Description);
+    embed->set_title(std::string(packet.Title));
+    embed->set_description(std::string(packet.Description));
+    embed->fields.reserve(packet.EmbedFields.size());
 
     for (auto const& embedField : packet.EmbedFields)
     {
@@ -50,10 +65,47 @@ void DiscordSession::HandleSendDiscordEmbedMessageOpcode(DiscordPackets::Message
         if (!embedField.IsCorrectValue())
             LOG_ERROR("discord", "> Incorrect size for embed value. Size {}. Context '{}'", embedField.Value.size(), embedField.Value);
 
-        embed->add_field(embedField.Name, embedField.Value, embedField.IsInline);
+        embed->add_field(std::string(embedField.Name), std::string(embedField.Value), embedField.IsInline);
     }
 
     embed->set_timestamp(packet.Timestamp);
 
-    sDiscordBot->SendEmbedMessage(channelID, embed);
+    sDiscordBot->SendEmbedMessage(channelID, embed, GetMessageCompleteHandler(packet.Sequence));
+}
+
+void DiscordSession::HandleSendDiscordEventOpcode(DiscordPackets::Message::SendDiscordEvent& packet)
+{
+    if (!CheckMessageSequence(packet.Sequence))
+        return;
+
+    auto channelID = GetChannelID(packet.ChannelType);
+    if (!channelID)
+    {
+        CompleteMessage(packet.Sequence, false);
+        return;
+    }
+
+    auto eventTemplate = sEventTemplateMgr->GetTemplate(GetGuildId(), packet.TemplateID);
+    if (!eventTemplate)
+    {
+        LOG_ERROR("discord", "> Not found event template {} for guild {}. Account {}", packet.TemplateID, GetGuildId(), GetAccountName());
+        CompleteMessage(packet.Sequence, false);
+        return;
+    }
+
+    if (packet.Params.size() < eventTemplate->GetParamsCount())
+    {
+        LOG_ERROR("discord", "> Event template {} for guild {} needs {} params, received {}. Account {}",
+            packet.TemplateID, GetGuildId(), eventTemplate->GetParamsCount(), packet.Params.size(), GetAccountName());
+        CompleteMessage(packet.Sequence, false);
+        return;
+    }
+
+    if (eventTemplate->IsDefaultMessage())
+    {
+        sDiscordBot->SendDefaultMessage(channelID, eventTemplate->Description.Render(packet.Params), GetMessageCompleteHandler(packet.Sequence));
+        return;
+    }
+
+    sDiscordBot->SendEmbedMessage(channelID, eventTemplate->BuildEmbed(packet.Params), GetMessageCompleteHandler(packet.Sequence));
 }
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AccountAuthCache.h"
+#include "AccountStore.h"
+#include "Config.h"
+#include "Field.h"
+#include "GameTime.h"
+#include "Log.h"
+#include <mutex>
+
+//             0         1           2               3              4                5             6               7
+// SELECT `a`.`ID`, `a`.`Salt`, `a`.`Verifier`, `a`.`GuildID`, `a`.`RealmName`, `a`.`LastIP`, `a`.`CoreName`, `a`.`ModuleVersion`
+// FROM `account` a WHERE `a`.`Name` = ? LIMIT 1
+AccountAuthInfo::AccountAuthInfo(Field* fields)
+{
+    ID                  = fields[0].Get<uint32>();
+    Salt                = fields[1].Get<Binary, Warhead::Crypto::SRP6::SALT_LENGTH>();
+    Verifier            = fields[2].Get<Binary, Warhead::Crypto::SRP6::VERIFIER_LENGTH>();
+    GuildID             = fields[3].Get<uint64>();
+    RealmName           = fields[4].Get<std::string>();
+    LastIP              = fields[5].Get<std::string>();
+    CoreName            = fields[6].Get<std::string>();
+    ModuleVersion       = fields[7].Get<uint32>();
+}
+
+AccountAuthCache* AccountAuthCache::instance()
+{
+    static AccountAuthCache instance;
+    return &instance;
+}
+
+void AccountAuthCache::Initialize()
+{
+    _cacheTime = Seconds(sConfigMgr->GetOption<uint32>("Network.AuthCache.Time", 600));
+
+    if (!IsEnabled())
+        LOG_INFO("server", "> Account auth cache disabled");
+}
+
+AccountAuthInfoPtr AccountAuthCache::Get(std::string_view accountName)
+{
+    if (!IsEnabled())
+        return nullptr;
+
+    std::string name = AccountStore::FoldName(accountName);
+
+    {
+        std::shared_lock<std::shared_mutex> guard(_lock);
+
+        auto itr = _cache.find(name);
+        if (itr != _cache.end() && itr->second.ExpireTime > GameTime::GetGameTime())
+        {
+            ++_hits;
+            return itr->second.Info;
+        }
+    }
+
+    ++_misses;
+    return nullptr;
+}
+
+void AccountAuthCache::Add(std::string_view accountName, AccountAuthInfoPtr info, uint32 generation)
+{
+    if (!IsEnabled() || !info)
+        return;
+
+    std::string name = AccountStore::FoldName(accountName);
+    Seconds now = GameTime::GetGameTime();
+
+    std::unique_lock<std::shared_mutex> guard(_lock);
+
+    // Account was changed while the query was in flight
+    if (generation != _generation.load())
+        return;
+
+    // Expired entries are dropped on insert, cache holds only existing accounts
+    std::erase_if(_cache, [now](auto const& entry) { return entry.second.ExpireTime <= now; });
+
+    _cache.insert_or_assign(std::move(name), CacheEntry{ std::move(info), now + _cacheTime });
+}
+
+void AccountAuthCache::Invalidate(std::string_view accountName)
+{
+    std::string name = AccountStore::FoldName(accountName);
+
+    std::unique_lock<std::shared_mutex> guard(_lock);
+    ++_generation;
+    _cache.erase(name);
+}
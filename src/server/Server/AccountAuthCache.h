@@ -0,0 +1,94 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ACCOUNT_AUTH_CACHE_H_
+#define _ACCOUNT_AUTH_CACHE_H_
+
+#include "DatabaseEnvFwd.h"
+#include "Define.h"
+#include "Duration.h"
+#include "SRP6.h"
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+struct AccountAuthInfo
+{
+    explicit AccountAuthInfo(Field* fields);
+
+    uint32 ID{ 0 };
+    Warhead::Crypto::SRP6::Salt Salt{};
+    Warhead::Crypto::SRP6::Verifier Verifier{};
+    uint64 GuildID{ 0 };
+    std::string RealmName;
+    std::string CoreName;
+    uint32 ModuleVersion{ 0 };
+    std::string LastIP;
+};
+
+using AccountAuthInfoPtr = std::shared_ptr<AccountAuthInfo const>;
+
+// Read-through cache of DISCORD_SEL_ACCOUNT_INFO_BY_NAME for auth.
+// Account writes invalidate entries, results of queries started before are dropped
+class WH_SERVER_API AccountAuthCache
+{
+    AccountAuthCache() = default;
+    ~AccountAuthCache() = default;
+
+    AccountAuthCache(AccountAuthCache const&) = delete;
+    AccountAuthCache(AccountAuthCache&&) = delete;
+    AccountAuthCache& operator=(AccountAuthCache const&) = delete;
+    AccountAuthCache& operator=(AccountAuthCache&&) = delete;
+
+public:
+    static AccountAuthCache* instance();
+
+    void Initialize();
+    inline bool IsEnabled() const { return _cacheTime > 0s; }
+
+    AccountAuthInfoPtr Get(std::string_view accountName);
+
+    // Generation must be taken before the query
+    inline uint32 GetGeneration() const { return _generation.load(); }
+    void Add(std::string_view accountName, AccountAuthInfoPtr info, uint32 generation);
+
+    void Invalidate(std::string_view accountName);
+
+    inline uint64 GetHits() const { return _hits.load(); }
+    inline uint64 GetMisses() const { return _misses.load(); }
+
+private:
+    struct CacheEntry
+    {
+        AccountAuthInfoPtr Info;
+        Seconds ExpireTime;
+    };
+
+    std::unordered_map<std::string, CacheEntry> _cache;
+    std::shared_mutex _lock;
+    std::atomic<uint32> _generation{ 0 };
+    std::atomic<uint64> _hits{ 0 };
+    std::atomic<uint64> _misses{ 0 };
+    Seconds _cacheTime{ 0s };
+};
+
+#define sAccountAuthCache AccountAuthCache::instance()
+
+#endif
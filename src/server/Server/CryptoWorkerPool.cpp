@@ -0,0 +1,116 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CryptoWorkerPool.h"
+#include "Config.h"
+#include "Log.h"
+#include "Util.h"
+
+CryptoWorkerPool* CryptoWorkerPool::instance()
+{
+    static CryptoWorkerPool instance;
+    return &instance;
+}
+
+void CryptoWorkerPool::Start()
+{
+    int32 threadCount = sConfigMgr->GetOption<int32>("Network.CryptoThreads", 1);
+    if (threadCount < 1)
+        threadCount = 1;
+
+    _cacheTime = Seconds(sConfigMgr->GetOption<uint32>("Network.CryptoCache.Time", 300));
+    _nextCacheCleanup = std::chrono::steady_clock::now() + _cacheTime;
+
+    _work.emplace(boost::asio::make_work_guard(_ioContext.get_executor()));
+
+    for (int32 i = 0; i < threadCount; ++i)
+        _threads.emplace_back([this]() { _ioContext.run(); });
+
+    LOG_INFO("server", "> Started {} crypto threads", threadCount);
+}
+
+void CryptoWorkerPool::Stop()
+{
+    _work.reset();
+    _ioContext.stop();
+
+    for (auto& thread : _threads)
+        thread.join();
+
+    _threads.clear();
+}
+
+Warhead::Async::CallbackAwaiter<bool> CryptoWorkerPool::CheckKey(uint32 accountID, std::string accountName, std::string key,
+    Warhead::Crypto::SRP6::Salt const& salt, Warhead::Crypto::SRP6::Verifier const& verifier)
+{
+    // SRP6 needs both values upper-cased once with the same function used at account creation
+    Utf8ToUpperOnlyLatin(accountName);
+    Utf8ToUpperOnlyLatin(key);
+
+    return Warhead::Async::CallbackAwaiter<bool>([this, accountID, accountName = std::move(accountName), key = std::move(key), salt, verifier](std::function<void(bool)>&& complete)
+    {
+        Warhead::Crypto::SHA256::Digest digest{};
+
+        if (_cacheTime > 0s)
+        {
+            digest = Warhead::Crypto::SHA256::GetDigestOf(salt, accountName, ":", key);
+
+            if (IsCachedKey(accountID, digest, verifier))
+            {
+                complete(true);
+                return;
+            }
+        }
+
+        Warhead::Asio::post(_ioContext, [this, complete = std::move(complete), accountID, accountName, key, salt, verifier, digest]()
+        {
+            bool isCorrect = Warhead::Crypto::SRP6::CheckLogin(accountName, key, salt, verifier);
+            if (isCorrect && _cacheTime > 0s)
+                AddCachedKey(accountID, digest, verifier);
+
+            complete(isCorrect);
+        });
+    });
+}
+
+bool CryptoWorkerPool::IsCachedKey(uint32 accountID, Warhead::Crypto::SHA256::Digest const& digest, Warhead::Crypto::SRP6::Verifier const& verifier)
+{
+    std::lock_guard<std::mutex> guard(_cacheLock);
+
+    auto const& itr = _cache.find(accountID);
+    if (itr == _cache.end())
+        return false;
+
+    // Verifier is changed with password, old digest is not valid
+    auto const& cachedKey = itr->second;
+    return cachedKey.ExpireTime > std::chrono::steady_clock::now() && cachedKey.Verifier == verifier && cachedKey.Digest == digest;
+}
+
+void CryptoWorkerPool::AddCachedKey(uint32 accountID, Warhead::Crypto::SHA256::Digest const& digest, Warhead::Crypto::SRP6::Verifier const& verifier)
+{
+    TimePoint now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> guard(_cacheLock);
+
+    _cache[accountID] = { digest, verifier, now + _cacheTime };
+
+    if (now < _nextCacheCleanup)
+        return;
+
+    std::erase_if(_cache, [now](auto const& itr) { return itr.second.ExpireTime <= now; });
+    _nextCacheCleanup = now + _cacheTime;
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CRYPTO_WORKER_POOL_H_
+#define _CRYPTO_WORKER_POOL_H_
+
+#include "Coroutine.h"
+#include "CryptoHash.h"
+#include "Define.h"
+#include "Duration.h"
+#include "IoContext.h"
+#include "Optional.h"
+#include "SRP6.h"
+#include <boost/asio/executor_work_guard.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// SRP6 verification out of network threads with cache of verified credentials
+class WH_SERVER_API CryptoWorkerPool
+{
+    CryptoWorkerPool() = default;
+    ~CryptoWorkerPool() = default;
+
+    CryptoWorkerPool(CryptoWorkerPool const&) = delete;
+    CryptoWorkerPool(CryptoWorkerPool&&) = delete;
+    CryptoWorkerPool& operator=(CryptoWorkerPool const&) = delete;
+    CryptoWorkerPool& operator=(CryptoWorkerPool&&) = delete;
+
+public:
+    static CryptoWorkerPool* instance();
+
+    void Start();
+    void Stop();
+
+    // Account name and key are raw values from client.
+    // Awaiting coroutine is resumed on its own executor once a crypto thread checked the key
+    Warhead::Async::CallbackAwaiter<bool> CheckKey(uint32 accountID, std::string accountName, std::string key,
+        Warhead::Crypto::SRP6::Salt const& salt, Warhead::Crypto::SRP6::Verifier const& verifier);
+
+private:
+    struct VerifiedKey
+    {
+        Warhead::Crypto::SHA256::Digest Digest{};
+        Warhead::Crypto::SRP6::Verifier Verifier{};
+        TimePoint ExpireTime;
+    };
+
+    bool IsCachedKey(uint32 accountID, Warhead::Crypto::SHA256::Digest const& digest, Warhead::Crypto::SRP6::Verifier const& verifier);
+    void AddCachedKey(uint32 accountID, Warhead::Crypto::SHA256::Digest const& digest, Warhead::Crypto::SRP6::Verifier const& verifier);
+
+    Warhead::Asio::IoContext _ioContext;
+    Optional<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> _work;
+    std::vector<std::thread> _threads;
+
+    // Verified credentials
+    Seconds _cacheTime{ 0s };
+    TimePoint _nextCacheCleanup;
+    std::unordered_map<uint32, VerifiedKey> _cache;
+    std::mutex _cacheLock;
+};
+
+#define sCryptoWorkerPool CryptoWorkerPool::instance()
+
+#endif
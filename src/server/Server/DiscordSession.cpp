@@ -18,11 +18,15 @@
 #include "DiscordSession.h"
 #include "DatabaseEnv.h"
 #include "DiscordPacket.h"
+#include "DiscordBot.h"
 #include "DiscordSocket.h"
+#include "DiscordSocketMgr.h"
 #include "Log.h"
+#include "MessagePackets.h"
 #include "Opcodes.h"
 #include "PacketUtilities.h"
 #include "QueryHolder.h"
+#include "StringDictionary.h"
 #include "Timer.h"
 #include "Discord.h"
 
@@ -35,10 +39,14 @@ DiscordSession::DiscordSession(uint32 id, int64 guidID, std::string&& name, Disc
     _guildID(guidID),
     _channels(std::move(channels)),
     _accountName(std::move(name)),
-    _latency(0us)
+    _latency(0us),
+    _messageAckQueue(std::make_shared<MPSCQueue<MessageAckInfo>>())
 {
     if (_socket)
-        _address = _socket->GetRemoteIpAddress().to_string();
+    {
+        _remoteIpAddress = _socket->GetRemoteIpAddress();
+        _address = _remoteIpAddress.to_string();
+    }
 }
 
 /// DiscordSession destructor
@@ -104,6 +112,12 @@ bool DiscordSession::Update()
         OpcodeClient opcode = static_cast<OpcodeClient>(packet->GetOpcode());
         ClientOpcodeHandler const* opHandle = opcodeTable[opcode];
 
+        if (_stringDictionary)
+        {
+            _stringDictionary->BeginPacket();
+            packet->SetStringDictionary(_stringDictionary.get());
+        }
+
         try
         {
             opHandle->Call(this, *packet);
@@ -121,6 +135,10 @@ bool DiscordSession::Update()
                 LOG_DEBUG("network", "Dumping error causing packet:");
                 packet->hexlike();
             }
+
+            // Client table can't be in sync with our after partially parsed packet
+            if (_stringDictionary)
+                KickSession("String dictionary desync");
         }
 
         delete packet;
@@ -134,6 +152,7 @@ bool DiscordSession::Update()
     }
 
     ProcessQueryCallbacks();
+    ProcessMessageAcks();
 
     if (_socket && !_socket->IsOpen())
         _socket.reset();
@@ -144,6 +163,125 @@ bool DiscordSession::Update()
     return true;
 }
 
+void DiscordSession::SetStringDictionarySize(uint32 size)
+{
+    if (!size)
+    {
+        _stringDictionary.reset();
+        return;
+    }
+
+    _stringDictionary = std::make_unique<StringDictionary>(size);
+}
+
+bool DiscordSession::CheckMessageSequence(uint32 sequence)
+{
+    // Client don't want ack
+    if (!sequence)
+        return true;
+
+    if (sequence != _lastReceivedSequence + 1)
+    {
+        LOG_ERROR("network", "> Account {} sent message sequence {}, expected {}", GetAccountId(), sequence, _lastReceivedSequence + 1);
+        KickSession("Incorrect message sequence");
+        return false;
+    }
+
+    _lastReceivedSequence = sequence;
+
+    if (_messageAckWindow && sequence - _lastAckedSequence > _messageAckWindow)
+    {
+        LOG_WARN("network", "> Account {} exceeded window of {} unacked messages. Drop message {}", GetAccountId(), _messageAckWindow, sequence);
+        CompleteMessage(sequence, false);
+        return false;
+    }
+
+    return true;
+}
+
+void DiscordSession::CompleteMessage(uint32 sequence, bool isDelivered)
+{
+    if (sequence)
+        _messageAckQueue->Enqueue(new MessageAckInfo{ sequence, isDelivered });
+}
+
+std::function<void(bool)> DiscordSession::GetMessageCompleteHandler(uint32 sequence)
+{
+    auto outboundQueue = sDiscordBot->GetOutboundQueue(_guildID);
+    ++(*outboundQueue);
+
+    // Session can be deleted before dpp callback, so keep only queues
+    return [queue = _messageAckQueue, outboundQueue, sequence](bool isDelivered)
+    {
+        --(*outboundQueue);
+
+        if (sequence)
+            queue->Enqueue(new MessageAckInfo{ sequence, isDelivered });
+    };
+}
+
+void DiscordSession::UpdateThrottle()
+{
+    uint32 queueLimit = sDiscordSocketMgr.GetThrottleQueueLimit();
+    if (!queueLimit || !_socket)
+        return;
+
+    uint32 queueSize = sDiscordBot->GetOutboundQueueSize(_guildID);
+    uint32 rate{ 0 };
+    uint32 burst{ 0 };
+
+    // Linear from max values at empty queue to pause at queue limit
+    if (queueSize < queueLimit)
+    {
+        uint32 freeSize = queueLimit - queueSize;
+        rate = std::max<uint32>(1, uint64(sDiscordSocketMgr.GetThrottleMaxRate()) * freeSize / queueLimit);
+        burst = std::clamp<uint32>(uint64(sDiscordSocketMgr.GetThrottleMaxBurst()) * freeSize / queueLimit, 1, freeSize);
+    }
+
+    if (_throttleSent && rate == _throttleRate && burst == _throttleBurst)
+        return;
+
+    _throttleSent = true;
+    _throttleRate = rate;
+    _throttleBurst = burst;
+
+    LOG_DEBUG("network", "> Account {} throttle. Rate {}, burst {}, guild queue {}", GetAccountId(), rate, burst, queueSize);
+
+    DiscordPackets::Message::Throttle packet;
+    packet.Rate = rate;
+    packet.Burst = burst;
+    packet.QueueSize = queueSize;
+    SendPacket(packet.Write());
+}
+
+void DiscordSession::ProcessMessageAcks()
+{
+    MessageAckInfo* ack{ nullptr };
+
+    while (_messageAckQueue->Dequeue(ack))
+    {
+        _completedMessages.emplace(ack->Sequence, ack->IsDelivered);
+        delete ack;
+    }
+
+    if (_completedMessages.empty() || _completedMessages.begin()->first != _lastAckedSequence + 1)
+        return;
+
+    // One cumulative ack for all messages completed since last update
+    DiscordPackets::Message::MessageAck messageAck;
+
+    for (auto itr = _completedMessages.begin(); itr != _completedMessages.end() && itr->first == _lastAckedSequence + 1; itr = _completedMessages.erase(itr))
+    {
+        _lastAckedSequence = itr->first;
+
+        if (!itr->second)
+            messageAck.FailedSequences.emplace_back(itr->first);
+    }
+
+    messageAck.CumulativeSequence = _lastAckedSequence;
+    SendPacket(messageAck.Write());
+}
+
 bool DiscordSession::HandleSocketClosed()
 {
     if (_socket && !_socket->IsOpen() && !Discord::IsStopped())
@@ -23,10 +23,15 @@
 #include "Define.h"
 #include "DiscordSharedDefines.h"
 #include "Duration.h"
+#include "MPSCQueue.h"
 #include "PacketQueue.h"
+#include <boost/asio/ip/address.hpp>
+#include <functional>
+#include <map>
 
 class DiscordPacket;
 class DiscordSocket;
+class StringDictionary;
 
 namespace DiscordPackets
 {
@@ -44,9 +49,16 @@ namespace DiscordPackets
     {
         class SendDiscordMessage;
         class SendDiscordEmbedMessage;
+        class SendDiscordEvent;
     }
 }
 
+struct MessageAckInfo
+{
+    uint32 Sequence{ 0 };
+    bool IsDelivered{ false };
+};
+
 /// Player session in the Discord
 class WH_SERVER_API DiscordSession
 {
@@ -60,6 +72,7 @@ public:
     inline int64 GetGuildId() const { return _guildID; }
     inline std::string const& GetAccountName() const { return _accountName; }
     inline std::string const& GetRemoteAddress() { return _address; }
+    inline boost::asio::ip::address const& GetRemoteIpAddress() const { return _remoteIpAddress; }
 
     void QueuePacket(DiscordPacket const& packet);
     bool Update();
@@ -68,6 +81,19 @@ public:
     void KickSession(std::string_view reason, bool setKicked = true);
     void SetKicked(bool val) { _kicked = val; }
 
+    // Must be set before auth response, 0 disables dictionary
+    void SetStringDictionarySize(uint32 size);
+
+    // Message acks. Max unacked messages, 0 - without limit
+    void SetMessageAckWindow(uint32 window) { _messageAckWindow = window; }
+    bool CheckMessageSequence(uint32 sequence);
+    void CompleteMessage(uint32 sequence, bool isDelivered);
+    // Counts message in guild outbound queue, call only for message passed to bot
+    std::function<void(bool)> GetMessageCompleteHandler(uint32 sequence);
+
+    // Send throttle to client if allowed rate changed with guild outbound queue
+    void UpdateThrottle();
+
     Microseconds GetLatency() const { return _latency; }
     void SetLatency(int64 latency) { _latency = Microseconds{ latency }; }
 
@@ -79,6 +105,7 @@ public:
     // Message
     void HandleSendDiscordMessageOpcode(DiscordPackets::Message::SendDiscordMessage& packet);
     void HandleSendDiscordEmbedMessageOpcode(DiscordPackets::Message::SendDiscordEmbedMessage& packet);
+    void HandleSendDiscordEventOpcode(DiscordPackets::Message::SendDiscordEvent& packet);
 
     // Auth
     void SendAuthResponse(DiscordAuthResponseCodes code);
@@ -101,6 +128,7 @@ public: // opcodes handlers
 
 private:
     void ProcessQueryCallbacks();
+    void ProcessMessageAcks();
 
     QueryCallbackProcessor _queryProcessor;
     AsyncCallbackProcessor<TransactionCallback> _transactionCallbacks;
@@ -115,6 +143,7 @@ private:
 
     std::shared_ptr<DiscordSocket> _socket;
     std::string _address;
+    boost::asio::ip::address _remoteIpAddress;
     uint32 _accountId;
     int64 _guildID;
     std::string _accountName;
@@ -122,6 +151,19 @@ private:
     bool _kicked{ false };
     DiscordChannelsList _channels;
     PacketQueue<DiscordPacket> _recvQueue;
+    std::unique_ptr<StringDictionary> _stringDictionary;
+
+    // Message acks
+    uint32 _messageAckWindow{ 0 };
+    uint32 _lastReceivedSequence{ 0 };
+    uint32 _lastAckedSequence{ 0 };
+    std::map<uint32, bool> _completedMessages; // completed after a gap, wait for previous sequences
+    std::shared_ptr<MPSCQueue<MessageAckInfo>> _messageAckQueue; // filled from dpp threads
+
+    // Throttle
+    bool _throttleSent{ false };
+    uint32 _throttleRate{ 0 };
+    uint32 _throttleBurst{ 0 };
 
     DiscordSession(DiscordSession const& right) = delete;
     DiscordSession& operator=(DiscordSession const& right) = delete;
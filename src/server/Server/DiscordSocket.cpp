@@ -16,65 +16,60 @@
  */
 
 #include "DiscordSocket.h"
+#include "AccountAuthCache.h"
 #include "BanMgr.h"
 #include "Config.h"
 #include "CryptoHash.h"
 #include "CryptoRandom.h"
+#include "CryptoWorkerPool.h"
 #include "DatabaseEnv.h"
 #include "Discord.h"
 #include "DiscordBot.h"
 #include "DiscordPacketHeader.h"
 #include "DiscordSession.h"
 #include "DiscordSharedDefines.h"
+#include "DiscordSocketMgr.h"
 #include "GameTime.h"
 #include "IPLocation.h"
 #include "Opcodes.h"
+#include "QueryCompletion.h"
+#include "ResumeTokenMgr.h"
 #include "SRP6.h"
 #include "SmartEnum.h"
+#include <boost/asio/post.hpp>
 
 using boost::asio::ip::tcp;
 
 DiscordSocket::DiscordSocket(tcp::socket&& socket)
-    : Socket(std::move(socket)), _OverSpeedPings(0), _discordSession(nullptr), _authed(false), _sendBufferSize(READ_BLOCK_SIZE)
+    : Socket(std::move(socket)), _OverSpeedPings(0), _discordSession(nullptr), _authed(false), _resumeTried(false), _hasAuthSlot(true), _sendBufferSize(READ_BLOCK_SIZE)
 {
     _headerBuffer.Resize(sizeof(DiscordClientPktHeader));
 }
 
+DiscordSocket::~DiscordSocket() = default;
+
 void DiscordSocket::Start()
 {
-    DiscordDatabasePreparedStatement* stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_IP_INFO);
-    stmt->SetArguments(GetRemoteIpAddress().to_string());
-
-    _queryProcessor.AddCallback(DiscordDatabase.AsyncQuery(stmt).WithPreparedCallback(std::bind(&DiscordSocket::CheckIpCallback, this, std::placeholders::_1)));
+    SetDeadline(sDiscordSocketMgr.GetHandshakeTimeout(), SocketTimeoutReason::Handshake);
 
     LOG_DEBUG("network", "> Connect from {}", GetRemoteIpAddress().to_string());
-}
 
-void DiscordSocket::CheckIpCallback(PreparedQueryResult result)
-{
-    if (result)
+    // In-memory index of ip bans and CIDR ranges, no query per connection
+    if (auto banInfo = sBanMgr->GetBanInfoAddress(GetRemoteIpAddress()))
     {
-        do
+        if (banInfo->IsPermanently())
         {
-            auto const& [isBanned, isPermanentlyBanned] = result->FetchTuple<uint64, uint64>();
-
-            if (isPermanentlyBanned)
-            {
-                SendAuthResponseError(DiscordAuthResponseCodes::BannedPermanentlyIP);
-                LOG_ERROR("network", "DiscordSocket::CheckIpCallback: Sent Auth Response 'BannedPermanentlyIP' (IP {} permanently banned).", GetRemoteIpAddress().to_string());
-                DelayedCloseSocket();
-                return;
-            }
-
-            if (isBanned)
-            {
-                SendAuthResponseError(DiscordAuthResponseCodes::BannedIP);
-                LOG_ERROR("network", "DiscordSocket::CheckIpCallback: Sent Auth Response 'BannedIP' (IP {} banned).", GetRemoteIpAddress().to_string());
-                DelayedCloseSocket();
-                return;
-            }
+            SendAuthResponseError(DiscordAuthResponseCodes::BannedPermanentlyIP);
+            LOG_ERROR("network", "DiscordSocket::Start: Sent Auth Response 'BannedPermanentlyIP' (IP {} permanently banned).", GetRemoteIpAddress().to_string());
+        }
+        else
+        {
+            SendAuthResponseError(DiscordAuthResponseCodes::BannedIP);
+            LOG_ERROR("network", "DiscordSocket::Start: Sent Auth Response 'BannedIP' (IP {} banned).", GetRemoteIpAddress().to_string());
+        }
 
-        } while (result->NextRow());
+        DelayedCloseSocket();
+        return;
     }
 
     AsyncRead();
@@ -120,8 +115,6 @@ bool DiscordSocket::Update()
     if (buffer.GetActiveSize() > 0)
         QueuePacket(std::move(buffer));
 
-    _queryProcessor.ProcessReadyCallbacks();
-
     return true;
 }
 
@@ -132,6 +125,14 @@ void DiscordSocket::OnClose()
         _discordSession = nullptr;
         LOG_DEBUG("network", "> Disconnect from {}", GetRemoteIpAddress().to_string());
     }
+
+    ReleaseAuthSlot();
+}
+
+void DiscordSocket::ReleaseAuthSlot()
+{
+    if (_hasAuthSlot.exchange(false))
+        sDiscordSocketMgr.ReleaseAuthSlot();
 }
 
 void DiscordSocket::ReadHandler()
@@ -226,67 +227,14 @@ struct AuthSession
     std::string CoreName;
     std::string CoreVersion;
     uint32 ModuleVersion{ 0 };
+    uint32 StringDictionarySize{ 0 };
 };
 
-struct AccountInfo
+struct AccountInfo : public AccountAuthInfo
 {
-    uint32 ID{ 0 };
-    Warhead::Crypto::SRP6::Salt Salt{};
-    Warhead::Crypto::SRP6::Verifier Verifier{};
-    uint64 GuildID{ 0 };
-    std::string RealmName;
-    std::string CoreName;
-    uint32 ModuleVersion{ 0 };
-    std::string LastIP;
-    Seconds BanDate{ 0s };
-    Seconds UnBanDate{ 0s };
-    bool IsBanned{ false };
-    bool IsPermanentlyBanned{ false };
-    std::unique_ptr<boost::asio::ip::address> RemoteIpAddress;
-
-    //             0         1           2               3                4             5               6
-    // SELECT `a`.`ID`, `a`.`Salt`, `a`.`Verifier`, `a`.`RealmName`, `a`.`LastIP`, `a`.`CoreName`, `a`.`ModuleVersion`
-    //       7              8
-    // `ab`.`bandate`, `ab`.`unbandate`
-    // FROM `account` a
-    // LEFT JOIN `account_banned` ab ON `a`.`id` = `ab`.`id` AND `ab`.`active` = 1 WHERE `a`.`Name` = ? LIMIT 1
+    explicit AccountInfo(AccountAuthInfo const& info) : AccountAuthInfo(info) { }
 
-    explicit AccountInfo(Field* fields)
-    {
-        ID                  = fields[0].Get<uint32>();
-        Salt                = fields[1].Get<Binary, Warhead::Crypto::SRP6::SALT_LENGTH>();
-        Verifier            = fields[2].Get<Binary, Warhead::Crypto::SRP6::VERIFIER_LENGTH>();
-        GuildID             = fields[3].Get<uint64>();
-        RealmName           = fields[4].Get<std::string>();
-        LastIP              = fields[5].Get<std::string>();
-        CoreName            = fields[6].Get<std::string>();
-        ModuleVersion       = fields[7].Get<uint32>();
-
-        if (!fields[8].IsNull())
-            BanDate = fields[8].Get<Seconds>(false);
-
-        if (!fields[9].IsNull())
-            UnBanDate = fields[9].Get<Seconds>(false);
-
-        if (UnBanDate > 0s && UnBanDate < GameTime::GetGameTime())
-            IsBanned = true;
-
-        if (BanDate > 0s && BanDate == UnBanDate)
-            IsPermanentlyBanned = true;
-    }
-
-    inline bool CheckKey(std::string const& accountName, std::string const& key)
-    {
-        std::string safeAccount = accountName;
-        std::transform(safeAccount.begin(), safeAccount.end(), safeAccount.begin(), ::toupper);
-        Utf8ToUpperOnlyLatin(safeAccount);
-
-        std::string safeKey = key;
-        Utf8ToUpperOnlyLatin(safeKey);
-        std::transform(safeKey.begin(), safeKey.end(), safeKey.begin(), ::toupper);
-
-        return Warhead::Crypto::SRP6::CheckLogin(safeAccount, safeKey, Salt, Verifier);
-    }
+    std::unique_ptr<boost::asio::ip::address> RemoteIpAddress;
 };
 
 DiscordSocket::ReadDataHandlerResult DiscordSocket::ReadDataHandler()
@@ -341,6 +289,27 @@ DiscordSocket::ReadDataHandlerResult DiscordSocket::ReadDataHandler()
             LOG_ERROR("network", "DiscordSocket::ReadDataHandler(): client {} sent malformed CMSG_AUTH_SESSION", GetRemoteIpAddress().to_string());
             return ReadDataHandlerResult::Error;
         }
+        case CLIENT_RESUME_SESSION:
+        {
+            LogOpcodeText(opcode);
+            if (_authed)
+            {
+                LOG_ERROR("network", "DiscordSocket::ReadDataHandler(): client {} sent CLIENT_RESUME_SESSION after auth", GetRemoteIpAddress().to_string());
+                return ReadDataHandlerResult::Error;
+            }
+
+            try
+            {
+                return HandleResumeSession(packet) ? ReadDataHandlerResult::Ok : ReadDataHandlerResult::Error;
+            }
+            catch (ByteBufferException const&)
+            {
+
+            }
+
+            LOG_ERROR("network", "DiscordSocket::ReadDataHandler(): client {} sent malformed CLIENT_RESUME_SESSION", GetRemoteIpAddress().to_string());
+            return ReadDataHandlerResult::Error;
+        }
         default:
             packetToQueue = new DiscordPacket(std::move(packet));
             break;
@@ -393,6 +362,8 @@ void DiscordSocket::SendPacket(DiscordPacket const& packet)
 
 void DiscordSocket::HandleAuthSession(DiscordPacket& recvPacket)
 {
+    SetDeadline(sDiscordSocketMgr.GetAuthTimeout(), SocketTimeoutReason::Auth);
+
     std::shared_ptr<AuthSession> authSession = std::make_shared<AuthSession>();
 
     // Read the content of the packet
@@ -402,45 +373,74 @@ void DiscordSocket::HandleAuthSession(DiscordPacket& recvPacket)
     recvPacket >> authSession->CoreVersion;
     recvPacket >> authSession->ModuleVersion;
 
-    // Get the account information from the database
-    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_ACCOUNT_INFO_BY_NAME);
-    stmt->SetArguments(authSession->Account);
+    // Optional, old clients don't send it
+    if (recvPacket.rpos() < recvPacket.size())
+        recvPacket >> authSession->StringDictionarySize;
 
-    _queryProcessor.AddCallback(DiscordDatabase.AsyncQuery(stmt).WithPreparedCallback(std::bind(&DiscordSocket::HandleAuthSessionCallback, this, authSession, std::placeholders::_1)));
+    HandleAuthSessionAccount(authSession).Start(GetCoroutineExecutor());
 }
 
-void DiscordSocket::HandleAuthSessionCallback(std::shared_ptr<AuthSession> authSession, PreparedQueryResult result)
+Warhead::Async::Task<> DiscordSocket::HandleAuthSessionAccount(std::shared_ptr<AuthSession> authSession)
 {
-    // Stop if the account is not found
-    if (!result)
+    AccountAuthInfoPtr authInfo = sAccountAuthCache->Get(authSession->Account);
+    if (!authInfo)
     {
-        // We can not log here, as we do not know the account. Thus, no accountId.
-        SendAuthResponseError(DiscordAuthResponseCodes::UnknownAccount);
-        LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (unknown account).");
-        DelayedCloseSocket();
-        return;
+        uint32 cacheGeneration = sAccountAuthCache->GetGeneration();
+
+        // Get the account information from the database
+        auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_ACCOUNT_INFO_BY_NAME);
+        stmt->SetArguments(authSession->Account);
+
+        QueryCallback query = DiscordDatabase.AsyncQuery(stmt, SQLPriority::Interactive);
+        std::shared_ptr<QueryCompletion> completion = query.GetCompletion();
+
+        PreparedQueryResult result = co_await std::move(query);
+        if (!IsOpen())
+            co_return;
+
+        // Database outage, the query was rejected without running
+        if (completion->IsRejected())
+        {
+            SendAuthResponseError(DiscordAuthResponseCodes::ServerOffline);
+            LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (database unavailable).");
+            DelayedCloseSocket();
+            co_return;
+        }
+
+        // Stop if the account is not found
+        if (!result)
+        {
+            // We can not log here, as we do not know the account. Thus, no accountId.
+            SendAuthResponseError(DiscordAuthResponseCodes::UnknownAccount);
+            LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (unknown account).");
+            DelayedCloseSocket();
+            co_return;
+        }
+
+        authInfo = std::make_shared<AccountAuthInfo const>(result->Fetch());
+        sAccountAuthCache->Add(authSession->Account, authInfo, cacheGeneration);
     }
 
-    auto account = std::make_shared<AccountInfo>(result->Fetch());
+    auto account = std::make_shared<AccountInfo>(*authInfo);
 
     // For hook purposes, we get Remoteaddress at this point.
     account->RemoteIpAddress = std::make_unique<boost::asio::ip::address>(GetRemoteIpAddress());
 
-    if (account->IsPermanentlyBanned)
-    {
-        SendAuthResponseError(DiscordAuthResponseCodes::BannedPermanentlyAccount);
-        LOG_ERROR("network", "DiscordSocket::CheckIpCallback: Sent Auth Response 'BannedPermanentlyAccount' (Account {} permanently banned).", authSession->Account);
-        DelayedCloseSocket();
-        sBanMgr->AddAccount(authSession->Account, BanInfo(0s, account->BanDate));
-        return;
-    }
-    else if (account->IsBanned)
+    if (auto banInfo = sBanMgr->GetBanInfoAccount(account->ID))
     {
-        SendAuthResponseError(DiscordAuthResponseCodes::BannedAccount);
-        LOG_ERROR("network", "DiscordSocket::CheckIpCallback: Sent Auth Response 'BannedAccount' (Account {} banned).", authSession->Account);
+        if (banInfo->IsPermanently())
+        {
+            SendAuthResponseError(DiscordAuthResponseCodes::BannedPermanentlyAccount);
+            LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response 'BannedPermanentlyAccount' (Account {} permanently banned).", authSession->Account);
+        }
+        else
+        {
+            SendAuthResponseError(DiscordAuthResponseCodes::BannedAccount);
+            LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response 'BannedAccount' (Account {} banned).", authSession->Account);
+        }
+
         DelayedCloseSocket();
-        sBanMgr->AddAccount(authSession->Account, BanInfo(account->UnBanDate - GameTime::GetGameTime(), account->BanDate));
-        return;
+        co_return;
     }
 
     // First reject the connection if packet contains invalid data or realm state doesn't allow logging in
@@ -449,59 +449,142 @@ void DiscordSocket::HandleAuthSessionCallback(std::shared_ptr<AuthSession> authS
         SendAuthResponseError(DiscordAuthResponseCodes::ServerOffline);
         LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Discord closed, denying client ({}).", GetRemoteIpAddress().to_string());
         DelayedCloseSocket();
-        return;
+        co_return;
     }
 
-    if (!account->CheckKey(authSession->Account, authSession->Key))
+    // SRP6 check is slow, do it on crypto threads
+    bool isCorrectKey = co_await sCryptoWorkerPool->CheckKey(account->ID, authSession->Account, authSession->Key, account->Salt, account->Verifier);
+    if (!IsOpen())
+        co_return;
+
+    if (!isCorrectKey)
     {
         SendAuthResponseError(DiscordAuthResponseCodes::IncorrectKey);
         LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (incorrect key).");
         DelayedCloseSocket();
-        return;
+        co_return;
     }
 
     if (IpLocationRecord const* location = sIPLocation->GetLocationRecord(account->RemoteIpAddress->to_string()))
         _ipCountry = location->CountryCode;
 
-    sDiscordBot->CheckBotInGuild(account->GuildID, [this, authSession, account](bool isExist)
+    co_await HandleAuthSessionGuild(authSession, account);
+}
+
+Warhead::Async::Task<> DiscordSocket::HandleAuthSessionGuild(std::shared_ptr<AuthSession> authSession, std::shared_ptr<AccountInfo> account)
+{
+    bool isExist = co_await sDiscordBot->CheckBotInGuild(account->GuildID);
+    if (!IsOpen())
+        co_return;
+
+    if (!isExist)
     {
-        if (!isExist)
-        {
-            SendAuthResponseError(DiscordAuthResponseCodes::BotNotFound);
-            LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (bot not found).");
-            DelayedCloseSocket();
-            return;
-        }
+        SendAuthResponseError(DiscordAuthResponseCodes::BotNotFound);
+        LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (bot not found).");
+        DelayedCloseSocket();
+        co_return;
+    }
 
-        sDiscordBot->CheckChannels(account->GuildID, [this, authSession, account](DiscordChannelsList&& channelList)
-        {
-            if (channelList.empty())
-            {
-                SendAuthResponseError(DiscordAuthResponseCodes::ChannelsNotFound);
-                LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (channels not found).");
-                DelayedCloseSocket();
-                return;
-            }
+    DiscordChannelsList channelList = co_await sDiscordBot->CheckChannels(account->GuildID);
+    if (!IsOpen())
+        co_return;
 
-            if (channelList.size() != DEFAULT_CHANNELS_COUNT)
-            {
-                SendAuthResponseError(DiscordAuthResponseCodes::ChannelsIncorrect);
-                LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (channels incorrect).");
-                DelayedCloseSocket();
-                return;
-            }
+    if (channelList.empty())
+    {
+        SendAuthResponseError(DiscordAuthResponseCodes::ChannelsNotFound);
+        LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (channels not found).");
+        DelayedCloseSocket();
+        co_return;
+    }
 
-            LOG_INFO("network", "DiscordSocket::HandleAuthSession: Client '{}' authenticated successfully from {}", authSession->Account, account->RemoteIpAddress->to_string());
+    if (channelList.size() != DEFAULT_CHANNELS_COUNT)
+    {
+        SendAuthResponseError(DiscordAuthResponseCodes::ChannelsIncorrect);
+        LOG_ERROR("network", "DiscordSocket::HandleAuthSession: Sent Auth Response (channels incorrect).");
+        DelayedCloseSocket();
+        co_return;
+    }
 
-            _authed = true;
+    LOG_INFO("network", "DiscordSocket::HandleAuthSession: Client '{}' authenticated successfully from {}", authSession->Account, account->RemoteIpAddress->to_string());
 
-            _discordSession = new DiscordSession(account->ID, account->GuildID, std::move(authSession->Account), std::move(channelList), shared_from_this());
+    CreateSession(account->ID, account->GuildID, std::move(authSession->Account), std::move(channelList), authSession->StringDictionarySize);
 
-            sDiscord->AddSession(_discordSession);
+    AsyncRead();
+}
 
-            AsyncRead();
-        });
-    });
+Warhead::Async::Executor DiscordSocket::GetCoroutineExecutor()
+{
+    // Socket is kept alive until the coroutine ends
+    return [self = shared_from_this()](std::coroutine_handle<> handle)
+    {
+        boost::asio::post(self->GetIoExecutor(), [handle]() { handle.resume(); });
+    };
+}
+
+bool DiscordSocket::HandleResumeSession(DiscordPacket& recvPacket)
+{
+    // Only one try, client should use full auth after fail
+    if (_resumeTried)
+        return false;
+
+    _resumeTried = true;
+    SetDeadline(sDiscordSocketMgr.GetAuthTimeout(), SocketTimeoutReason::Auth);
+
+    uint16 tokenSize{ 0 };
+    uint32 stringDictionarySize{ 0 };
+
+    recvPacket >> tokenSize;
+    std::vector<uint8> token(tokenSize);
+
+    if (tokenSize)
+        recvPacket.read(token.data(), tokenSize);
+
+    // Optional, same as in auth session
+    if (recvPacket.rpos() < recvPacket.size())
+        recvPacket >> stringDictionarySize;
+
+    auto tokenInfo = sResumeTokenMgr->ConsumeToken(token);
+    if (!tokenInfo)
+    {
+        SendAuthResponseError(DiscordAuthResponseCodes::ResumeFailed);
+        LOG_DEBUG("network", "DiscordSocket::HandleResumeSession: Sent Auth Response (resume failed) to {}.", GetRemoteIpAddress().to_string());
+        return true;
+    }
+
+    if (sDiscord->IsClosed())
+    {
+        SendAuthResponseError(DiscordAuthResponseCodes::ServerOffline);
+        LOG_ERROR("network", "DiscordSocket::HandleResumeSession: Discord closed, denying client ({}).", GetRemoteIpAddress().to_string());
+        DelayedCloseSocket();
+        return true;
+    }
+
+    // Account could be banned after token was issued
+    if (auto banInfo = sBanMgr->GetBanInfoAccount(tokenInfo->AccountID))
+    {
+        SendAuthResponseError(banInfo->IsPermanently() ? DiscordAuthResponseCodes::BannedPermanentlyAccount : DiscordAuthResponseCodes::BannedAccount);
+        LOG_ERROR("network", "DiscordSocket::HandleResumeSession: Sent Auth Response (Account {} banned).", tokenInfo->AccountName);
+        DelayedCloseSocket();
+        return true;
+    }
+
+    LOG_INFO("network", "DiscordSocket::HandleResumeSession: Client '{}' resumed session from {}", tokenInfo->AccountName, GetRemoteIpAddress().to_string());
+
+    CreateSession(tokenInfo->AccountID, tokenInfo->GuildID, std::move(tokenInfo->AccountName), std::move(tokenInfo->Channels), stringDictionarySize);
+    return true;
+}
+
+void DiscordSocket::CreateSession(uint32 accountID, int64 guildID, std::string&& accountName, DiscordChannelsList&& channels, uint32 stringDictionarySize)
+{
+    _authed = true;
+    ReleaseAuthSlot();
+    SetDeadline(sDiscordSocketMgr.GetPingTimeout(), SocketTimeoutReason::Ping);
+
+    _discordSession = new DiscordSession(accountID, guildID, std::move(accountName), std::move(channels), shared_from_this());
+    _discordSession->SetStringDictionarySize(std::min(stringDictionarySize, sDiscordSocketMgr.GetStringDictionaryMaxSize()));
+    _discordSession->SetMessageAckWindow(sDiscordSocketMgr.GetMessageAckWindow());
+
+    sDiscord->AddSession(_discordSession);
 }
 
 void DiscordSocket::SendAuthResponseError(DiscordAuthResponseCodes code)
@@ -523,6 +606,9 @@ bool DiscordSocket::HandlePing(DiscordPacket& recvPacket)
     recvPacket >> timePacket;
     recvPacket >> latency;
 
+    if (_authed)
+        SetDeadline(sDiscordSocketMgr.GetPingTimeout(), SocketTimeoutReason::Ping);
+
     if (_LastPingTime == TimePoint())
     {
         _LastPingTime = steady_clock::now();
@@ -18,6 +18,7 @@
 #ifndef _DISCORD_SOCKET_H_
 #define _DISCORD_SOCKET_H_
 
+#include "Coroutine.h"
 #include "Define.h"
 #include "DiscordPacket.h"
 #include "DiscordSession.h"
@@ -29,6 +30,7 @@
 using boost::asio::ip::tcp;
 
 struct AuthSession;
+struct AccountInfo;
 enum class DiscordAuthResponseCodes : uint8;
 
 class WH_SERVER_API DiscordSocket : public Socket<DiscordSocket>
@@ -37,7 +39,7 @@ class WH_SERVER_API DiscordSocket : public Socket<DiscordSocket>
 
 public:
     DiscordSocket(tcp::socket&& socket);
-    ~DiscordSocket() = default;
+    ~DiscordSocket();
 
     DiscordSocket(DiscordSocket const& right) = delete;
     DiscordSocket& operator=(DiscordSocket const& right) = delete;
@@ -64,28 +66,35 @@ protected:
     ReadDataHandlerResult ReadDataHandler();
 
 private:
-    void CheckIpCallback(PreparedQueryResult result);
     void LogOpcodeText(OpcodeClient opcode) const;
     void SendPacketAndLogOpcode(DiscordPacket const& packet);
     void HandleAuthSession(DiscordPacket& recvPacket);
-    void HandleAuthSessionCallback(std::shared_ptr<AuthSession> authSession, PreparedQueryResult result);
+    Warhead::Async::Task<> HandleAuthSessionAccount(std::shared_ptr<AuthSession> authSession);
+    Warhead::Async::Task<> HandleAuthSessionGuild(std::shared_ptr<AuthSession> authSession, std::shared_ptr<AccountInfo> account);
     void SendAuthResponseError(DiscordAuthResponseCodes code);
+    bool HandleResumeSession(DiscordPacket& recvPacket);
+    void ReleaseAuthSlot();
+    void CreateSession(uint32 accountID, int64 guildID, std::string&& accountName, DiscordChannelsList&& channels, uint32 stringDictionarySize);
 
     bool HandlePing(DiscordPacket& recvPacket);
 
+    // Coroutines are resumed on the network thread of this socket
+    Warhead::Async::Executor GetCoroutineExecutor();
+
     TimePoint _LastPingTime;
     uint32 _OverSpeedPings;
 
     std::mutex _discordSessionLock;
     DiscordSession* _discordSession;
     bool _authed;
+    bool _resumeTried;
+    std::atomic<bool> _hasAuthSlot;
 
     MessageBuffer _headerBuffer;
     MessageBuffer _packetBuffer;
     MPSCQueue<DiscordPacket> _bufferQueue;
     std::size_t _sendBufferSize;
 
-    QueryCallbackProcessor _queryProcessor;
     std::string _ipCountry;
 };
 
@@ -16,9 +16,14 @@
  */
 
 #include "DiscordSocketMgr.h"
+#include "AccountAuthCache.h"
 #include "Config.h"
+#include "CryptoWorkerPool.h"
 #include "DiscordSocket.h"
 #include "NetworkThread.h"
+#include "Optional.h"
+#include "ResumeTokenMgr.h"
+#include "StringDictionary.h"
 #include <boost/system/error_code.hpp>
 
 class DiscordSocketThread : public NetworkThread<DiscordSocket>
@@ -35,7 +40,9 @@ public:
 };
 
 DiscordSocketMgr::DiscordSocketMgr() :
-    BaseSocketMgr(), _socketSystemSendBufferSize(-1), _socketApplicationSendBufferSize(65536), _tcpNoDelay(true)
+    BaseSocketMgr(), _socketSystemSendBufferSize(-1), _socketApplicationSendBufferSize(65536), _tcpNoDelay(true), _stringDictionaryMaxSize(4096), _messageAckWindow(64),
+    _throttleMaxRate(60), _throttleMaxBurst(10), _throttleQueueLimit(50),
+    _handshakeTimeout(10s), _authTimeout(30s), _pingTimeout(90s), _maxUnauthedSockets(100), _maxPendingSockets(100), _unauthedSockets(0), _reapedPendingSockets(0)
 {
 }
 
@@ -62,16 +69,57 @@ bool DiscordSocketMgr::StartDiscordNetwork(Warhead::Asio::IoContext& ioContext,
         return false;
     }
 
+    _stringDictionaryMaxSize = sConfigMgr->GetOption<uint32>("Network.StringDictionary.MaxSize", 4096);
+    if (_stringDictionaryMaxSize > StringDictionary::MAX_CAPACITY)
+    {
+        LOG_ERROR("server.loading", "Network.StringDictionary.MaxSize ({}) can't be more than {}, set to {}",
+            _stringDictionaryMaxSize, StringDictionary::MAX_CAPACITY, StringDictionary::MAX_CAPACITY);
+        _stringDictionaryMaxSize = StringDictionary::MAX_CAPACITY;
+    }
+
+    _messageAckWindow = sConfigMgr->GetOption<uint32>("Network.MessageAck.Window", 64);
+    _throttleMaxRate = sConfigMgr->GetOption<uint32>("Network.Throttle.MaxRate", 60);
+    _throttleMaxBurst = sConfigMgr->GetOption<uint32>("Network.Throttle.MaxBurst", 10);
+    _throttleQueueLimit = sConfigMgr->GetOption<uint32>("Network.Throttle.QueueLimit", 50);
+    _handshakeTimeout = Seconds(sConfigMgr->GetOption<uint32>("Network.Timeout.Handshake", 10));
+    _authTimeout = Seconds(sConfigMgr->GetOption<uint32>("Network.Timeout.Auth", 30));
+    _pingTimeout = Seconds(sConfigMgr->GetOption<uint32>("Network.Timeout.Ping", 90));
+
+    _acceptRateLimiter.SetGlobalLimit(sConfigMgr->GetOption<float>("Network.Accept.Rate", 50.0f), sConfigMgr->GetOption<uint32>("Network.Accept.Burst", 100));
+    _acceptRateLimiter.SetAddressLimit(sConfigMgr->GetOption<float>("Network.Accept.RatePerIP", 1.0f), sConfigMgr->GetOption<uint32>("Network.Accept.BurstPerIP", 5));
+    _maxUnauthedSockets = sConfigMgr->GetOption<uint32>("Network.MaxUnauthedSockets", 100);
+    _maxPendingSockets = sConfigMgr->GetOption<uint32>("Network.MaxPendingSockets", 100);
+
     if (!BaseSocketMgr::StartNetwork(ioContext, bindIp, port, threadCount))
         return false;
 
+    _acceptor->SetAcceptFilter([this](boost::asio::ip::address const& address)
+    {
+        if (_acceptRateLimiter.CanAccept(address))
+            return true;
+
+        LOG_DEBUG("network", "DiscordSocketMgr: Accept rate limit for {}", address.to_string());
+        return false;
+    });
+
+    // Key verification for auth sessions
+    sCryptoWorkerPool->Start();
+    sResumeTokenMgr->Initialize();
+    sAccountAuthCache->Initialize();
+
     _acceptor->AsyncAcceptWithCallback<&DiscordSocketMgr::OnSocketAccept>();
     return true;
 }
 
 void DiscordSocketMgr::StopNetwork()
 {
+    {
+        std::lock_guard<std::mutex> guard(_pendingSocketsLock);
+        _pendingSockets.clear();
+    }
+
     BaseSocketMgr::StopNetwork();
+    sCryptoWorkerPool->Stop();
 }
 
 void DiscordSocketMgr::OnSocketOpen(tcp::socket&& sock, uint32 threadIndex)
@@ -102,7 +150,82 @@ void DiscordSocketMgr::OnSocketOpen(tcp::socket&& sock, uint32 threadIndex)
         }
     }
 
-    BaseSocketMgr::OnSocketOpen(std::forward<tcp::socket>(sock), threadIndex);
+    if (_maxUnauthedSockets)
+    {
+        std::lock_guard<std::mutex> guard(_pendingSocketsLock);
+
+        if (_unauthedSockets >= _maxUnauthedSockets)
+        {
+            TimePoint now = std::chrono::steady_clock::now();
+            RemoveExpiredPendingSocketsLocked(now);
+
+            if (_pendingSockets.size() >= _maxPendingSockets)
+            {
+                LOG_DEBUG("network", "DiscordSocketMgr::OnSocketOpen: Pending sockets queue is full, drop connection");
+                boost::system::error_code err;
+                sock.close(err);
+                return;
+            }
+
+            // Time in queue counts against auth timeout, same as time of a started socket before auth
+            _pendingSockets.emplace_back(std::move(sock), threadIndex, _authTimeout > 0s ? now + _authTimeout : TimePoint::max());
+            return;
+        }
+
+        ++_unauthedSockets;
+    }
+
+    if (!StartSocket(std::move(sock), threadIndex))
+        ReleaseAuthSlot();
+}
+
+void DiscordSocketMgr::ReleaseAuthSlot()
+{
+    if (!_maxUnauthedSockets)
+        return;
+
+    // Slot goes to first pending socket which can be started
+    for (;;)
+    {
+        Optional<PendingSocket> pendingSocket;
+
+        {
+            std::lock_guard<std::mutex> guard(_pendingSocketsLock);
+            RemoveExpiredPendingSocketsLocked(std::chrono::steady_clock::now());
+
+            if (_pendingSockets.empty())
+            {
+                if (_unauthedSockets)
+                    --_unauthedSockets;
+
+                return;
+            }
+
+            pendingSocket.emplace(std::move(_pendingSockets.front()));
+            _pendingSockets.pop_front();
+        }
+
+        if (StartSocket(std::move(pendingSocket->Socket), pendingSocket->ThreadIndex))
+            return;
+    }
+}
+
+void DiscordSocketMgr::RemoveExpiredPendingSockets()
+{
+    std::lock_guard<std::mutex> guard(_pendingSocketsLock);
+    RemoveExpiredPendingSocketsLocked(std::chrono::steady_clock::now());
+}
+
+void DiscordSocketMgr::RemoveExpiredPendingSocketsLocked(TimePoint now)
+{
+    // Same timeout for all, oldest sockets are in front
+    while (!_pendingSockets.empty() && _pendingSockets.front().Deadline <= now)
+    {
+        boost::system::error_code err;
+        _pendingSockets.front().Socket.close(err);
+        _pendingSockets.pop_front();
+        ++_reapedPendingSockets;
+    }
 }
 
 NetworkThread<DiscordSocket>* DiscordSocketMgr::CreateThreads() const
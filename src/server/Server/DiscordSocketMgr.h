@@ -18,7 +18,11 @@
 #ifndef __WORLDSOCKETMGR_H
 #define __WORLDSOCKETMGR_H
 
+#include "AcceptRateLimiter.h"
 #include "SocketMgr.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
 
 class DiscordSocket;
 
@@ -38,7 +42,22 @@ public:
 
     void OnSocketOpen(tcp::socket&& sock, uint32 threadIndex) override;
 
+    // Socket is authed or closed before auth, start next pending socket
+    void ReleaseAuthSlot();
+
+    // Closes pending sockets which waited for auth slot longer than auth timeout
+    void RemoveExpiredPendingSockets();
+    uint64 GetReapedPendingSocketsCount() const { return _reapedPendingSockets; }
+
     std::size_t GetApplicationSendBufferSize() const { return _socketApplicationSendBufferSize; }
+    uint32 GetStringDictionaryMaxSize() const { return _stringDictionaryMaxSize; }
+    uint32 GetMessageAckWindow() const { return _messageAckWindow; }
+    uint32 GetThrottleMaxRate() const { return _throttleMaxRate; }
+    uint32 GetThrottleMaxBurst() const { return _throttleMaxBurst; }
+    uint32 GetThrottleQueueLimit() const { return _throttleQueueLimit; }
+    Seconds GetHandshakeTimeout() const { return _handshakeTimeout; }
+    Seconds GetAuthTimeout() const { return _authTimeout; }
+    Seconds GetPingTimeout() const { return _pingTimeout; }
 
 protected:
     DiscordSocketMgr();
@@ -51,9 +70,39 @@ protected:
     }
 
 private:
+    struct PendingSocket
+    {
+        PendingSocket(tcp::socket&& socket, uint32 threadIndex, TimePoint deadline) :
+            Socket(std::move(socket)), ThreadIndex(threadIndex), Deadline(deadline) { }
+
+        tcp::socket Socket;
+        uint32 ThreadIndex;
+        TimePoint Deadline;
+    };
+
+    // Caller must hold _pendingSocketsLock
+    void RemoveExpiredPendingSocketsLocked(TimePoint now);
+
     int32 _socketSystemSendBufferSize;
     int32 _socketApplicationSendBufferSize;
     bool _tcpNoDelay;
+    uint32 _stringDictionaryMaxSize;
+    uint32 _messageAckWindow;
+    uint32 _throttleMaxRate;
+    uint32 _throttleMaxBurst;
+    uint32 _throttleQueueLimit;
+    Seconds _handshakeTimeout;
+    Seconds _authTimeout;
+    Seconds _pingTimeout;
+
+    // Admission control
+    AcceptRateLimiter _acceptRateLimiter;
+    uint32 _maxUnauthedSockets;
+    uint32 _maxPendingSockets;
+    uint32 _unauthedSockets;
+    std::deque<PendingSocket> _pendingSockets; // accepted, wait for free auth slot
+    std::mutex _pendingSocketsLock;
+    std::atomic<uint64> _reapedPendingSockets;
 };
 
 #define sDiscordSocketMgr DiscordSocketMgr::Instance()
@@ -20,6 +20,7 @@
 #include "Log.h"
 #include "MessageBuffer.h"
 #include "StringConvert.h"
+#include "StringDictionary.h"
 #include "Timer.h"
 #include <ctime>
 #include <sstream>
@@ -75,6 +76,18 @@ ByteBuffer& ByteBuffer::operator>>(double& value)
     return *this;
 }
 
+ByteBuffer& ByteBuffer::operator>>(std::string& value)
+{
+    value = _stringDictionary ? std::string(_stringDictionary->Read(*this)) : ReadCString(true);
+    return *this;
+}
+
+ByteBuffer& ByteBuffer::operator>>(std::string_view& value)
+{
+    value = _stringDictionary ? _stringDictionary->Read(*this) : ReadCStringView(true);
+    return *this;
+}
+
 std::string ByteBuffer::ReadCString(bool requireValidUtf8 /*= true*/)
 {
     std::string value;
@@ -93,6 +106,27 @@ std::string ByteBuffer::ReadCString(bool requireValidUtf8 /*= true*/)
     return value;
 }
 
+std::string_view ByteBuffer::ReadCStringView(bool requireValidUtf8 /*= true*/)
+{
+    if (rpos() >= size())
+        return {};
+
+    char const* begin = reinterpret_cast<char const*>(&_storage[_rpos]);
+    std::size_t const left = size() - _rpos;
+
+    // prevent crash at wrong string format in packet, same as ReadCString
+    auto end = static_cast<char const*>(std::memchr(begin, 0, left));
+    std::size_t const length = end ? std::size_t(end - begin) : left;
+
+    std::string_view value{ begin, length };
+    _rpos += end ? length + 1 : length;
+
+    if (requireValidUtf8 && !utf8::is_valid(value.begin(), value.end()))
+        throw ByteBufferInvalidValueException("string", std::string(value).c_str());
+
+    return value;
+}
+
 uint32 ByteBuffer::ReadPackedTime()
 {
     uint32 packedDate = read<uint32>();
@@ -26,6 +26,7 @@
 #include <vector>
 
 class MessageBuffer;
+class StringDictionary;
 
 // Root of ByteBuffer exception hierarchy
 class WH_SERVER_API ByteBufferException : public std::exception
@@ -89,7 +90,7 @@ public:
     }
 
     ByteBuffer(ByteBuffer&& buf) noexcept :
-        _rpos(buf._rpos), _wpos(buf._wpos), _storage(std::move(buf._storage))
+        _rpos(buf._rpos), _wpos(buf._wpos), _storage(std::move(buf._storage)), _stringDictionary(buf._stringDictionary)
     {
         buf._rpos = 0;
         buf._wpos = 0;
@@ -106,6 +107,7 @@ public:
             _rpos = right._rpos;
             _wpos = right._wpos;
             _storage = right._storage;
+            _stringDictionary = right._stringDictionary;
         }
 
         return *this;
@@ -120,6 +122,7 @@ public:
             _wpos = right._wpos;
             right._wpos = 0;
             _storage = std::move(right._storage);
+            _stringDictionary = right._stringDictionary;
         }
 
         return *this;
@@ -294,11 +297,11 @@ public:
     ByteBuffer& operator>>(float& value);
     ByteBuffer& operator>>(double& value);
 
-    ByteBuffer& operator>>(std::string& value)
-    {
-        value = ReadCString(true);
-        return *this;
-    }
+    // Both resolve string dictionary indices if one is set for this buffer
+    ByteBuffer& operator>>(std::string& value);
+
+    // View points into _storage or into string dictionary, valid until the buffer is modified or destroyed
+    ByteBuffer& operator>>(std::string_view& value);
 
     uint8& operator[](size_t const pos)
     {
@@ -428,6 +431,7 @@ public:
     }
 
     std::string ReadCString(bool requireValidUtf8 = true);
+    std::string_view ReadCStringView(bool requireValidUtf8 = true);
     uint32 ReadPackedTime();
 
     ByteBuffer& ReadPackedTime(uint32& time)
@@ -537,6 +541,9 @@ public:
     }
 
     void AppendPackedTime(time_t time);
+
+    void SetStringDictionary(StringDictionary* dictionary) { _stringDictionary = dictionary; }
+
     void put(size_t pos, const uint8 *src, size_t cnt);
     void print_storage() const;
     void textlike() const;
@@ -545,6 +552,7 @@ public:
 protected:
     size_t _rpos{0}, _wpos{0};
     std::vector<uint8> _storage;
+    StringDictionary* _stringDictionary{ nullptr };
 };
 
 /// @todo Make a ByteBuffer.cpp and move all this inlining to it.
@@ -21,5 +21,15 @@ DiscordPacket const* DiscordPackets::Auth::AuthResponse::Write()
 {
     _worldPacket << uint8(Code);
 
+    if (Code == DiscordAuthResponseCodes::Ok)
+    {
+        _worldPacket << uint32(StringDictionarySize);
+        _worldPacket << uint32(MessageAckWindow);
+        _worldPacket << uint16(ResumeToken.size());
+
+        if (!ResumeToken.empty())
+            _worldPacket.append(ResumeToken.data(), ResumeToken.size());
+    }
+
     return &_worldPacket;
 }
@@ -31,6 +31,9 @@ namespace DiscordPackets::Auth
         DiscordPacket const* Write() override;
 
         DiscordAuthResponseCodes Code = DiscordAuthResponseCodes::Failed;
+        uint32 StringDictionarySize{ 0 }; // only for DiscordAuthResponseCodes::Ok
+        uint32 MessageAckWindow{ 0 }; // only for DiscordAuthResponseCodes::Ok
+        std::vector<uint8> ResumeToken; // only for DiscordAuthResponseCodes::Ok, empty if resume is disabled
     };
 }
 
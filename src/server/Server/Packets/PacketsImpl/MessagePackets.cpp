@@ -22,6 +22,9 @@ void DiscordPackets::Message::SendDiscordMessage::Read()
 {
     _worldPacket >> ChannelType;
     _worldPacket >> Context;
+
+    if (_worldPacket.rpos() < _worldPacket.size())
+        _worldPacket >> Sequence;
 }
 
 void DiscordPackets::Message::SendDiscordEmbedMessage::Read()
@@ -32,20 +35,84 @@ void DiscordPackets::Message::SendDiscordEmbedMessage::Read()
     _worldPacket >> Description;
     _worldPacket >> EmbedFieldsSize;
 
-    for (std::size_t i = 0; i < EmbedFieldsSize; i++)
+    // Throws PacketArrayMaxCapacityException before any field is parsed
+    EmbedFields.resize(EmbedFieldsSize);
+
+    for (auto& embedField : EmbedFields)
     {
-        std::string name;
-        std::string value;
-        bool isInline;
+        _worldPacket >> embedField.Name;
+        _worldPacket >> embedField.Value;
+        _worldPacket >> embedField.IsInline;
+    }
+
+    _worldPacket >> Timestamp;
+
+    if (_worldPacket.rpos() < _worldPacket.size())
+        _worldPacket >> Sequence;
+}
+
+void DiscordPackets::Message::SendDiscordEvent::Read()
+{
+    _worldPacket >> ChannelType;
+    _worldPacket >> TemplateID;
 
-        _worldPacket >> name;
-        _worldPacket >> value;
-        _worldPacket >> isInline;
+    uint8 paramsCount = _worldPacket.read<uint8>();
+    if (paramsCount > WARHEAD_DISCORD_MAX_EVENT_PARAMS)
+        throw PacketArrayMaxCapacityException(paramsCount, WARHEAD_DISCORD_MAX_EVENT_PARAMS);
 
-        auto embedField = EmbedField(name, value, isInline);
+    Params.reserve(paramsCount);
 
-        EmbedFields.emplace_back(embedField);
+    for (uint8 i = 0; i < paramsCount; i++)
+    {
+        switch (static_cast<DiscordEventParamType>(_worldPacket.read<uint8>()))
+        {
+            case DiscordEventParamType::Int64:
+                Params.emplace_back(_worldPacket.read<int64>());
+                break;
+            case DiscordEventParamType::UInt64:
+                Params.emplace_back(_worldPacket.read<uint64>());
+                break;
+            case DiscordEventParamType::Double:
+            {
+                double value;
+                _worldPacket >> value;
+                Params.emplace_back(value);
+                break;
+            }
+            case DiscordEventParamType::String:
+            {
+                std::string_view value;
+                _worldPacket >> value;
+                Params.emplace_back(value);
+                break;
+            }
+            case DiscordEventParamType::Bool:
+                Params.emplace_back(_worldPacket.read<uint8>() != 0);
+                break;
+            default:
+                throw ByteBufferInvalidValueException("DiscordEventParamType", "unknown");
+        }
     }
 
-    _worldPacket >> Timestamp;
+    if (_worldPacket.rpos() < _worldPacket.size())
+        _worldPacket >> Sequence;
+}
+
+DiscordPacket const* DiscordPackets::Message::MessageAck::Write()
+{
+    _worldPacket << uint32(CumulativeSequence);
+    _worldPacket << uint16(FailedSequences.size());
+
+    for (uint32 sequence : FailedSequences)
+        _worldPacket << uint32(sequence);
+
+    return &_worldPacket;
+}
+
+DiscordPacket const* DiscordPackets::Message::Throttle::Write()
+{
+    _worldPacket << uint32(Rate);
+    _worldPacket << uint32(Burst);
+    _worldPacket << uint32(QueueSize);
+    return &_worldPacket;
 }
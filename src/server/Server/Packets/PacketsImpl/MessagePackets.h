@@ -20,6 +20,7 @@
 
 #include "DiscordSharedDefines.h"
 #include "Packet.h"
+#include "PacketUtilities.h"
 
 namespace DiscordPackets::Message
 {
@@ -32,6 +33,27 @@ namespace DiscordPackets::Message
 
         uint8 ChannelType{ 0 };
         std::string Context;
+        uint32 Sequence{ 0 }; // optional, 0 - without ack
+    };
+
+    // All string views below point into _worldPacket storage.
+    // They are valid only while the packet object is alive, i.e. during the opcode handler call.
+    // Copy them if the data must outlive the handler.
+    struct EmbedFieldView
+    {
+        std::string_view Name;
+        std::string_view Value;
+        bool IsInline{ false };
+
+        bool IsCorrectName() const
+        {
+            return Name.size() <= 256;
+        }
+
+        bool IsCorrectValue() const
+        {
+            return Value.size() <= 1024;
+        }
     };
 
     class SendDiscordEmbedMessage final : public ClientPacket
@@ -43,11 +65,50 @@ namespace DiscordPackets::Message
 
         uint8 ChannelType{ 0 };
         uint32 Color{ 0 };
-        std::string Title;
-        std::string Description;
+        std::string_view Title;
+        std::string_view Description;
         std::size_t EmbedFieldsSize{ 0 };
         time_t Timestamp{ 0 };
-        DiscordEmbedFields EmbedFields;
+        Array<EmbedFieldView, WARHEAED_DISCORD_MAX_EMBED_FIELDS> EmbedFields;
+        uint32 Sequence{ 0 }; // optional, 0 - without ack
+    };
+
+    class SendDiscordEvent final : public ClientPacket
+    {
+    public:
+        SendDiscordEvent(DiscordPacket&& packet) : ClientPacket(CLIENT_SEND_EVENT, std::move(packet)) { }
+
+        void Read() override;
+
+        uint8 ChannelType{ 0 };
+        uint32 TemplateID{ 0 };
+        DiscordEventParams Params;
+        uint32 Sequence{ 0 }; // optional, 0 - without ack
+    };
+
+    // Cumulative ack, all messages up to CumulativeSequence are completed
+    class MessageAck final : public ServerPacket
+    {
+    public:
+        MessageAck() : ServerPacket(SERVER_SEND_MESSAGE_ACK, 4 + 2) { }
+
+        DiscordPacket const* Write() override;
+
+        uint32 CumulativeSequence{ 0 };
+        std::vector<uint32> FailedSequences; // not delivered messages in range since previous ack
+    };
+
+    // Advisory send limit for session, 0 rate - pause sending
+    class Throttle final : public ServerPacket
+    {
+    public:
+        Throttle() : ServerPacket(SERVER_SEND_THROTTLE, 4 + 4 + 4) { }
+
+        DiscordPacket const* Write() override;
+
+        uint32 Rate{ 0 }; // messages per minute
+        uint32 Burst{ 0 };
+        uint32 QueueSize{ 0 }; // guild outbound queue size
     };
 }
 
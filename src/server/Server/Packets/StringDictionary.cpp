@@ -0,0 +1,67 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StringDictionary.h"
+#include "ByteBuffer.h"
+#include "DiscordSharedDefines.h"
+#include "Errors.h"
+#include "StringConvert.h"
+
+StringDictionary::StringDictionary(uint32 capacity) : _capacity(capacity)
+{
+    ASSERT(_capacity <= MAX_CAPACITY);
+}
+
+std::string_view StringDictionary::Read(ByteBuffer& buffer)
+{
+    switch (static_cast<DiscordStringCode>(buffer.read<uint8>()))
+    {
+        case DiscordStringCode::Literal:
+            return buffer.ReadCStringView();
+        case DiscordStringCode::LiteralIndexed:
+            return Insert(buffer.ReadCStringView());
+        case DiscordStringCode::Indexed:
+        {
+            uint16 index = buffer.read<uint16>();
+            if (index >= _entries.size())
+                throw ByteBufferInvalidValueException("string dictionary index", Warhead::ToString(index).c_str());
+
+            return *_entries[index];
+        }
+        default:
+            throw ByteBufferInvalidValueException("string dictionary code", "unknown");
+    }
+}
+
+std::string_view StringDictionary::Insert(std::string_view value)
+{
+    std::size_t const entrySize = value.size() + ENTRY_OVERHEAD;
+
+    // Same as HPACK, entry bigger than table just empties it
+    while (!_entries.empty() && _size + entrySize > _capacity)
+    {
+        _size -= _entries.back()->size() + ENTRY_OVERHEAD;
+        _evicted.emplace_back(std::move(_entries.back()));
+        _entries.pop_back();
+    }
+
+    if (entrySize > _capacity)
+        return value;
+
+    _size += entrySize;
+    return *_entries.emplace_front(std::make_unique<std::string>(value));
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _STRING_DICTIONARY_H_
+#define _STRING_DICTIONARY_H_
+
+#include "Define.h"
+#include <deque>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ByteBuffer;
+
+/*
+ * HPACK-like dynamic table of strings already seen on one connection.
+ * Client mirrors the same table and sends repeated strings as an index.
+ * Entries are evicted oldest first when the table is over capacity, the size of one entry is its length + 32 bytes.
+ * Index 0 is the most recently inserted string.
+ */
+class WH_SERVER_API StringDictionary
+{
+public:
+    static constexpr std::size_t ENTRY_OVERHEAD = 32;
+
+    // Indices are uint16 on the wire, a table of this size never holds more entries
+    static constexpr uint32 MAX_CAPACITY = std::numeric_limits<uint16>::max();
+
+    explicit StringDictionary(uint32 capacity);
+
+    // Reads DiscordStringCode and string or index. Returned view is valid until the next BeginPacket() call
+    std::string_view Read(ByteBuffer& buffer);
+
+    // Frees strings evicted while parsing previous packet
+    void BeginPacket() { _evicted.clear(); }
+
+    inline uint32 GetCapacity() const { return _capacity; }
+    inline std::size_t GetSize() const { return _size; }
+    inline std::size_t GetEntriesCount() const { return _entries.size(); }
+
+private:
+    std::string_view Insert(std::string_view value);
+
+    // Strings are kept in own allocation, views to them must survive deque changes
+    std::deque<std::unique_ptr<std::string>> _entries;
+    std::vector<std::unique_ptr<std::string>> _evicted;
+    std::size_t _size{ 0 };
+    uint32 _capacity{ 0 };
+};
+
+#endif // _STRING_DICTIONARY_H_
@@ -132,10 +132,14 @@ void OpcodeTable::Initialize()
     DEFINE_HANDLER(CLIENT_SEND_MESSAGE,             &DiscordSession::HandleSendDiscordMessageOpcode);
     DEFINE_HANDLER(CLIENT_SEND_MESSAGE_EMBED,       &DiscordSession::HandleSendDiscordEmbedMessageOpcode);
     DEFINE_HANDLER(CLIENT_SEND_PING,                &DiscordSession::Handle_EarlyProccess);
+    DEFINE_HANDLER(CLIENT_SEND_EVENT,               &DiscordSession::HandleSendDiscordEventOpcode);
+    DEFINE_HANDLER(CLIENT_RESUME_SESSION,           &DiscordSession::Handle_EarlyProccess);
 
     // Server
     DEFINE_SERVER_OPCODE_HANDLER(SERVER_SEND_AUTH_RESPONSE);
     DEFINE_SERVER_OPCODE_HANDLER(SERVER_SEND_PONG);
+    DEFINE_SERVER_OPCODE_HANDLER(SERVER_SEND_MESSAGE_ACK);
+    DEFINE_SERVER_OPCODE_HANDLER(SERVER_SEND_THROTTLE);
 
 #undef DEFINE_HANDLER
 #undef DEFINE_SERVER_OPCODE_HANDLER
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResumeTokenMgr.h"
+#include "ByteBuffer.h"
+#include "Config.h"
+#include "CryptoRandom.h"
+#include "GameTime.h"
+#include "HMAC.h"
+#include "Log.h"
+#include <openssl/crypto.h>
+
+namespace
+{
+    constexpr uint8 RESUME_TOKEN_VERSION = 1;
+}
+
+ResumeTokenMgr* ResumeTokenMgr::instance()
+{
+    static ResumeTokenMgr instance;
+    return &instance;
+}
+
+void ResumeTokenMgr::Initialize()
+{
+    _tokenTime = Seconds(sConfigMgr->GetOption<uint32>("Network.ResumeToken.Time", 300));
+    Warhead::Crypto::GetRandomBytes(_secret);
+
+    if (!IsEnabled())
+        LOG_INFO("server", "> Session resume tokens disabled");
+}
+
+// Token: version, token id, account id, guild id, expire time, account name, channels, HMAC-SHA256 of all previous
+std::vector<uint8> ResumeTokenMgr::CreateToken(ResumeTokenInfo const& info)
+{
+    if (!IsEnabled())
+        return {};
+
+    ByteBuffer buffer;
+    buffer << uint8(RESUME_TOKEN_VERSION);
+    buffer << uint64(_nextTokenID++);
+    buffer << uint32(info.AccountID);
+    buffer << int64(info.GuildID);
+    buffer << int64((GameTime::GetGameTime() + _tokenTime).count());
+    buffer << info.AccountName;
+
+    for (int64 channelID : info.Channels)
+        buffer << int64(channelID);
+
+    buffer.append(Warhead::Crypto::HMAC_SHA256::GetDigestOf(_secret, buffer.contents(), buffer.size()));
+
+    return std::vector<uint8>(buffer.contents(), buffer.contents() + buffer.size());
+}
+
+Optional<ResumeTokenInfo> ResumeTokenMgr::ConsumeToken(std::vector<uint8> const& token)
+{
+    if (!IsEnabled() || token.size() <= Warhead::Crypto::HMAC_SHA256::DIGEST_LENGTH)
+        return {};
+
+    std::size_t dataSize = token.size() - Warhead::Crypto::HMAC_SHA256::DIGEST_LENGTH;
+    auto digest = Warhead::Crypto::HMAC_SHA256::GetDigestOf(_secret, token.data(), dataSize);
+
+    if (CRYPTO_memcmp(digest.data(), token.data() + dataSize, digest.size()) != 0)
+        return {};
+
+    ResumeTokenInfo info;
+    uint8 version{ 0 };
+    uint64 tokenID{ 0 };
+    int64 expireTime{ 0 };
+
+    try
+    {
+        ByteBuffer buffer;
+        buffer.append(token.data(), dataSize);
+
+        buffer >> version;
+        if (version != RESUME_TOKEN_VERSION)
+            return {};
+
+        buffer >> tokenID;
+        buffer >> info.AccountID;
+        buffer >> info.GuildID;
+        buffer >> expireTime;
+        buffer >> info.AccountName;
+
+        for (int64& channelID : info.Channels)
+            buffer >> channelID;
+    }
+    catch (ByteBufferException const&)
+    {
+        return {};
+    }
+
+    Seconds const now = GameTime::GetGameTime();
+    if (Seconds(expireTime) < now)
+        return {};
+
+    std::lock_guard<std::mutex> guard(_usedTokensLock);
+
+    if (!_usedTokens.emplace(tokenID, Seconds(expireTime)).second)
+        return {};
+
+    if (now >= _nextUsedCleanup)
+    {
+        std::erase_if(_usedTokens, [now](auto const& itr) { return itr.second < now; });
+        _nextUsedCleanup = now + _tokenTime;
+    }
+
+    return info;
+}
@@ -0,0 +1,76 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RESUME_TOKEN_MGR_H_
+#define _RESUME_TOKEN_MGR_H_
+
+#include "Define.h"
+#include "DiscordSharedDefines.h"
+#include "Duration.h"
+#include "Optional.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ResumeTokenInfo
+{
+    uint32 AccountID{ 0 };
+    int64 GuildID{ 0 };
+    std::string AccountName;
+    DiscordChannelsList Channels{};
+};
+
+// Signed tokens to restore session after reconnect without full auth.
+// Secret is generated at startup, tokens don't survive restart. Every token can be used once
+class WH_SERVER_API ResumeTokenMgr
+{
+    ResumeTokenMgr() = default;
+    ~ResumeTokenMgr() = default;
+
+    ResumeTokenMgr(ResumeTokenMgr const&) = delete;
+    ResumeTokenMgr(ResumeTokenMgr&&) = delete;
+    ResumeTokenMgr& operator=(ResumeTokenMgr const&) = delete;
+    ResumeTokenMgr& operator=(ResumeTokenMgr&&) = delete;
+
+public:
+    static ResumeTokenMgr* instance();
+
+    void Initialize();
+    inline bool IsEnabled() const { return _tokenTime > 0s; }
+
+    std::vector<uint8> CreateToken(ResumeTokenInfo const& info);
+
+    // Empty for invalid, expired or already used token
+    Optional<ResumeTokenInfo> ConsumeToken(std::vector<uint8> const& token);
+
+private:
+    std::array<uint8, 32> _secret{};
+    Seconds _tokenTime{ 0s };
+    std::atomic<uint64> _nextTokenID{ 1 };
+
+    // Token id -> expire time of used tokens, kept until the token would have expired anyway
+    std::unordered_map<uint64, Seconds> _usedTokens;
+    Seconds _nextUsedCleanup{ 0s };
+    std::mutex _usedTokensLock;
+};
+
+#define sResumeTokenMgr ResumeTokenMgr::instance()
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EventTemplateMgr.h"
+#include "Containers.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "StopWatch.h"
+#include "StringConvert.h"
+#include "StringFormat.h"
+#include <dpp/dpp.h>
+#include <iterator>
+
+bool CompiledTemplateString::Compile(std::string_view text, std::string& error)
+{
+    _literals.clear();
+    _segments.clear();
+    _paramsCount = 0;
+
+    _literals.reserve(text.size());
+
+    auto AddLiteral = [this](std::string_view part)
+    {
+        if (part.empty())
+            return;
+
+        // Merge with previous literal, {{ and }} should not split the text
+        if (!_segments.empty() && _segments.back().ParamIndex < 0)
+            _segments.back().Length += part.size();
+        else
+            _segments.emplace_back(Segment{ _literals.size(), part.size(), -1 });
+
+        _literals.append(part);
+    };
+
+    std::size_t pos = 0;
+
+    while (pos < text.size())
+    {
+        auto next = text.find_first_of("{}", pos);
+        if (next == std::string_view::npos)
+        {
+            AddLiteral(text.substr(pos));
+            break;
+        }
+
+        AddLiteral(text.substr(pos, next - pos));
+
+        // Escaped brace
+        if (next + 1 < text.size() && text[next + 1] == text[next])
+        {
+            AddLiteral(text.substr(next, 1));
+            pos = next + 2;
+            continue;
+        }
+
+        if (text[next] == '}')
+        {
+            error = Warhead::StringFormat("unmatched '}}' at position {}", next);
+            return false;
+        }
+
+        auto close = text.find('}', next);
+        if (close == std::string_view::npos)
+        {
+            error = Warhead::StringFormat("unclosed '{{' at position {}", next);
+            return false;
+        }
+
+        auto index = Warhead::StringTo<uint8>(text.substr(next + 1, close - next - 1));
+        if (!index || *index >= WARHEAD_DISCORD_MAX_EVENT_PARAMS)
+        {
+            error = Warhead::StringFormat("incorrect placeholder '{}' at position {}", text.substr(next, close - next + 1), next);
+            return false;
+        }
+
+        _segments.emplace_back(Segment{ 0, 0, int16(*index) });
+        _paramsCount = std::max<uint8>(_paramsCount, *index + 1);
+        pos = close + 1;
+    }
+
+    return true;
+}
+
+std::string CompiledTemplateString::Render(DiscordEventParams const& params) const
+{
+    std::string result;
+    result.reserve(_literals.size() + _paramsCount * 16);
+
+    for (auto const& segment : _segments)
+    {
+        if (segment.ParamIndex < 0)
+        {
+            result.append(_literals, segment.Offset, segment.Length);
+            continue;
+        }
+
+        if (std::size_t(segment.ParamIndex) >= params.size())
+            continue;
+
+        std::visit([&result](auto const& value)
+        {
+            fmt::format_to(std::back_inserter(result), "{}", value);
+        }, params[segment.ParamIndex]);
+    }
+
+    return result;
+}
+
+uint8 EventTemplate::GetParamsCount() const
+{
+    uint8 count = std::max(Title.GetParamsCount(), Description.GetParamsCount());
+
+    for (auto const& field : Fields)
+        count = std::max({ count, field.Name.GetParamsCount(), field.Value.GetParamsCount() });
+
+    return count;
+}
+
+std::shared_ptr<dpp::embed> EventTemplate::BuildEmbed(DiscordEventParams const& params) const
+{
+    auto embed = std::make_shared<dpp::embed>();
+    embed->set_color(Color);
+
+    if (!Title.IsEmpty())
+        embed->set_title(Title.Render(params));
+
+    embed->set_description(Description.Render(params));
+    embed->fields.reserve(Fields.size());
+
+    for (auto const& field : Fields)
+        embed->add_field(field.Name.Render(params), field.Value.Render(params), field.IsInline);
+
+    embed->set_timestamp(GameTime::GetGameTime().count());
+    return embed;
+}
+
+/*static*/ EventTemplateMgr* EventTemplateMgr::instance()
+{
+    static EventTemplateMgr instance;
+    return &instance;
+}
+
+void EventTemplateMgr::LoadTemplates()
+{
+    LOG_INFO("server.loading", "> Loading event templates...");
+
+    StopWatch sw;
+
+    _templates.clear();
+
+    auto result = DiscordDatabase.Query(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_EVENT_TEMPLATES));
+    if (!result)
+    {
+        LOG_INFO("server.loading", "> Loaded 0 event templates. DB table `event_templates` is empty");
+        LOG_INFO("server.loading", "");
+        return;
+    }
+
+    std::size_t count = 0;
+
+    do
+    {
+        auto const& [guildID, id, color, title, description] = result->FetchTuple<int64, uint32, uint32, std::string_view, std::string_view>();
+
+        EventTemplate eventTemplate;
+        eventTemplate.ID = id;
+        eventTemplate.GuildID = guildID;
+        eventTemplate.Color = color;
+
+        std::string error;
+
+        if (!eventTemplate.Title.Compile(title, error) || !eventTemplate.Description.Compile(description, error))
+        {
+            LOG_ERROR("sql.sql", "> Event template {} for guild {} has {}. Skip", id, guildID, error);
+            continue;
+        }
+
+        _templates[guildID].emplace(id, std::move(eventTemplate));
+        count++;
+    } while (result->NextRow());
+
+    LoadTemplateFields();
+
+    LOG_INFO("server.loading", "> Loaded {} event templates in {}", count, sw);
+    LOG_INFO("server.loading", "");
+}
+
+void EventTemplateMgr::LoadTemplateFields()
+{
+    auto result = DiscordDatabase.Query(DiscordDatabase.GetPreparedStatement(DISCORD_SEL_EVENT_TEMPLATE_FIELDS));
+    if (!result)
+        return;
+
+    do
+    {
+        auto const& [guildID, templateID, name, value, isInline] = result->FetchTuple<int64, uint32, std::string_view, std::string_view, bool>();
+
+        auto guildTemplates = Warhead::Containers::MapGetValuePtr(_templates, guildID);
+        auto eventTemplate = guildTemplates ? Warhead::Containers::MapGetValuePtr(*guildTemplates, templateID) : nullptr;
+        if (!eventTemplate)
+        {
+            LOG_ERROR("sql.sql", "> Event template field for non existing template {} for guild {}. Skip", templateID, guildID);
+            continue;
+        }
+
+        if (eventTemplate->Fields.size() >= WARHEAED_DISCORD_MAX_EMBED_FIELDS)
+        {
+            LOG_ERROR("sql.sql", "> Event template {} for guild {} has more than {} fields. Skip", templateID, guildID, WARHEAED_DISCORD_MAX_EMBED_FIELDS);
+            continue;
+        }
+
+        EventTemplateField field;
+        field.IsInline = isInline;
+
+        std::string error;
+
+        if (!field.Name.Compile(name, error) || !field.Value.Compile(value, error))
+        {
+            LOG_ERROR("sql.sql", "> Event template {} field for guild {} has {}. Skip", templateID, guildID, error);
+            continue;
+        }
+
+        eventTemplate->Fields.emplace_back(std::move(field));
+    } while (result->NextRow());
+}
+
+EventTemplate const* EventTemplateMgr::GetTemplate(int64 guildID, uint32 templateID) const
+{
+    auto guildTemplates = Warhead::Containers::MapGetValuePtr(_templates, guildID);
+    return guildTemplates ? Warhead::Containers::MapGetValuePtr(*guildTemplates, templateID) : nullptr;
+}
@@ -0,0 +1,110 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _EVENT_TEMPLATE_MGR_H_
+#define _EVENT_TEMPLATE_MGR_H_
+
+#include "Define.h"
+#include "DiscordSharedDefines.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dpp
+{
+    struct embed;
+}
+
+/// Template text split at load into literal parts and {N} placeholders, so rendering is a single pass without parsing
+class WH_SERVER_API CompiledTemplateString
+{
+    struct Segment
+    {
+        std::size_t Offset{ 0 };
+        std::size_t Length{ 0 };
+        int16 ParamIndex{ -1 }; // -1 for literal text
+    };
+
+public:
+    CompiledTemplateString() = default;
+
+    // Placeholders are {0}..{15}, use {{ and }} for literal braces
+    bool Compile(std::string_view text, std::string& error);
+    std::string Render(DiscordEventParams const& params) const;
+
+    inline uint8 GetParamsCount() const { return _paramsCount; }
+    inline bool IsEmpty() const { return _segments.empty(); }
+
+private:
+    std::string _literals;
+    std::vector<Segment> _segments;
+    uint8 _paramsCount{ 0 };
+};
+
+struct EventTemplateField
+{
+    CompiledTemplateString Name;
+    CompiledTemplateString Value;
+    bool IsInline{ false };
+};
+
+struct EventTemplate
+{
+    uint32 ID{ 0 };
+    int64 GuildID{ 0 };
+    uint32 Color{ 0 };
+    CompiledTemplateString Title;
+    CompiledTemplateString Description;
+    std::vector<EventTemplateField> Fields;
+
+    // Max params count used by any part of template
+    uint8 GetParamsCount() const;
+
+    // Plain text template, without title and fields
+    bool IsDefaultMessage() const { return Title.IsEmpty() && Fields.empty(); }
+
+    std::shared_ptr<dpp::embed> BuildEmbed(DiscordEventParams const& params) const;
+};
+
+class WH_SERVER_API EventTemplateMgr
+{
+    EventTemplateMgr() = default;
+    ~EventTemplateMgr() = default;
+
+    EventTemplateMgr(EventTemplateMgr const&) = delete;
+    EventTemplateMgr(EventTemplateMgr&&) = delete;
+    EventTemplateMgr& operator=(EventTemplateMgr const&) = delete;
+    EventTemplateMgr& operator=(EventTemplateMgr&&) = delete;
+
+public:
+    static EventTemplateMgr* instance();
+
+    void LoadTemplates();
+
+    EventTemplate const* GetTemplate(int64 guildID, uint32 templateID) const;
+
+private:
+    void LoadTemplateFields();
+
+    // GuildID -> TemplateID -> template
+    std::unordered_map<int64, std::unordered_map<uint32, EventTemplate>> _templates;
+};
+
+#define sEventTemplateMgr EventTemplateMgr::instance()
+
+#endif // _EVENT_TEMPLATE_MGR_H_
@@ -22,6 +22,7 @@
 #include <array>
 #include <string>
 #include <string_view>
+#include <variant>
 #include <vector>
 
 // EnumUtils: DESCRIBE THIS
@@ -36,6 +37,11 @@ enum DiscordCode : uint16
     SERVER_SEND_AUTH_RESPONSE,
     SERVER_SEND_PONG,
 
+    CLIENT_SEND_EVENT,
+    SERVER_SEND_MESSAGE_ACK,
+    SERVER_SEND_THROTTLE,
+    CLIENT_RESUME_SESSION,
+
     MAX_DISCORD_CODE
 };
 
@@ -57,6 +63,7 @@ enum class DiscordAuthResponseCodes : uint8
     BotNotFound,
     ChannelsNotFound,
     ChannelsIncorrect,
+    ResumeFailed,
 };
 
 // EnumUtils: DESCRIBE THIS
@@ -84,28 +91,31 @@ enum class DiscordMessageColor : uint32
     White   = 0xffffff
 };
 
-struct EmbedField
+constexpr std::size_t WARHEAED_DISCORD_MAX_EMBED_FIELDS = 24;
+
+// Type tag written before every CLIENT_SEND_EVENT parameter
+enum class DiscordEventParamType : uint8
 {
-    EmbedField(std::string_view name, std::string_view value, bool isInline) :
-        Name(name), Value(value), IsInline(isInline) { }
-
-    std::string Name;
-    std::string Value;
-    bool IsInline{ false };
-
-    bool IsCorrectName() const
-    {
-        return Name.size() <= 256;
-    }
-
-    bool IsCorrectValue() const
-    {
-        return Value.size() <= 1024;
-    }
+    Int64,
+    UInt64,
+    Double,
+    String,
+    Bool
 };
 
-constexpr std::size_t WARHEAED_DISCORD_MAX_EMBED_FIELDS = 24;
-using DiscordEmbedFields = std::vector<EmbedField>;
+constexpr std::size_t WARHEAD_DISCORD_MAX_EVENT_PARAMS = 16;
+
+// Prefix of every string in client packets when string dictionary was negotiated at auth
+enum class DiscordStringCode : uint8
+{
+    Literal,        // cstring, not added to dictionary
+    LiteralIndexed, // cstring, added to dictionary at index 0
+    Indexed         // uint16 index in dictionary
+};
+
+// String params are views into the received packet, valid only during the opcode handler call
+using DiscordEventParam = std::variant<int64, uint64, double, std::string_view, bool>;
+using DiscordEventParams = std::vector<DiscordEventParam>;
 
 constexpr auto WARHEAD_DISCORD_VERSION = 100000;
 constexpr auto GetVersionMajor() { return WARHEAD_DISCORD_VERSION / 100000; }
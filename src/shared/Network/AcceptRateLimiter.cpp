@@ -0,0 +1,98 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AcceptRateLimiter.h"
+
+namespace
+{
+    constexpr Seconds ADDRESS_BUCKETS_CLEANUP_INTERVAL = 60s;
+}
+
+void AcceptRateLimiter::TokenBucket::Refill(float rate, uint32 burst, TimePoint now)
+{
+    float elapsed = std::chrono::duration<float>(now - LastUpdate).count();
+    Tokens = std::min<float>(float(burst), Tokens + elapsed * rate);
+    LastUpdate = now;
+}
+
+bool AcceptRateLimiter::TokenBucket::TryTake(float rate, uint32 burst, TimePoint now)
+{
+    Refill(rate, burst, now);
+
+    if (Tokens < 1.0f)
+        return false;
+
+    Tokens -= 1.0f;
+    return true;
+}
+
+void AcceptRateLimiter::SetGlobalLimit(float rate, uint32 burst)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    _globalRate = rate;
+    _globalBurst = std::max<uint32>(1, burst);
+    _globalBucket = { float(_globalBurst), std::chrono::steady_clock::now() };
+}
+
+void AcceptRateLimiter::SetAddressLimit(float rate, uint32 burst)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    _addressRate = rate;
+    _addressBurst = std::max<uint32>(1, burst);
+    _addressBuckets.clear();
+}
+
+bool AcceptRateLimiter::CanAccept(boost::asio::ip::address const& address)
+{
+    TimePoint now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_addressRate > 0.0f)
+    {
+        if (now >= _nextCleanup)
+            RemoveFullBuckets(now);
+
+        auto [itr, isNew] = _addressBuckets.try_emplace(address, TokenBucket{ float(_addressBurst), now });
+        if (!itr->second.TryTake(_addressRate, _addressBurst, now))
+            return false;
+    }
+
+    // Address limit first, so one address can't spend global tokens after own limit
+    if (_globalRate > 0.0f && !_globalBucket.TryTake(_globalRate, _globalBurst, now))
+        return false;
+
+    return true;
+}
+
+void AcceptRateLimiter::RemoveFullBuckets(TimePoint now)
+{
+    // Full bucket is the same as new one
+    for (auto itr = _addressBuckets.begin(); itr != _addressBuckets.end();)
+    {
+        itr->second.Refill(_addressRate, _addressBurst, now);
+
+        if (itr->second.Tokens >= float(_addressBurst))
+            itr = _addressBuckets.erase(itr);
+        else
+            ++itr;
+    }
+
+    _nextCleanup = now + ADDRESS_BUCKETS_CLEANUP_INTERVAL;
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ACCEPT_RATE_LIMITER_H_
+#define _ACCEPT_RATE_LIMITER_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include <boost/asio/ip/address.hpp>
+#include <map>
+#include <mutex>
+
+// Token buckets for accepted connections, global and per remote address
+class WH_SHARED_API AcceptRateLimiter
+{
+public:
+    AcceptRateLimiter() = default;
+
+    // Rate is connections per second, 0 - without limit
+    void SetGlobalLimit(float rate, uint32 burst);
+    void SetAddressLimit(float rate, uint32 burst);
+
+    bool CanAccept(boost::asio::ip::address const& address);
+
+private:
+    struct TokenBucket
+    {
+        float Tokens{ 0.0f };
+        TimePoint LastUpdate;
+
+        void Refill(float rate, uint32 burst, TimePoint now);
+        bool TryTake(float rate, uint32 burst, TimePoint now);
+    };
+
+    void RemoveFullBuckets(TimePoint now);
+
+    std::mutex _lock;
+
+    float _globalRate{ 0.0f };
+    uint32 _globalBurst{ 0 };
+    TokenBucket _globalBucket;
+
+    float _addressRate{ 0.0f };
+    uint32 _addressBurst{ 0 };
+    std::map<boost::asio::ip::address, TokenBucket> _addressBuckets;
+    TimePoint _nextCleanup;
+};
+
+#endif
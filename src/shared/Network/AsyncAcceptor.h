@@ -57,7 +57,14 @@ public:
                 {
                     socket->non_blocking(true);
 
-                    acceptCallback(std::move(*socket), threadIndex);
+                    // Drop before any socket object is created
+                    if (_acceptFilter && !_acceptFilter(socket->remote_endpoint().address()))
+                    {
+                        boost::system::error_code err;
+                        socket->close(err);
+                    }
+                    else
+                        acceptCallback(std::move(*socket), threadIndex);
                 }
                 catch (boost::system::system_error const& err)
                 {
@@ -116,6 +123,7 @@ public:
     }
 
     void SetSocketFactory(std::function<std::pair<tcp::socket*, uint32>()> func) { _socketFactory = func; }
+    void SetAcceptFilter(std::function<bool(boost::asio::ip::address const&)> func) { _acceptFilter = func; }
 
 private:
     std::pair<tcp::socket*, uint32> DefeaultSocketFactory() { return std::make_pair(&_socket, 0); }
@@ -125,6 +133,7 @@ private:
     tcp::socket _socket;
     std::atomic<bool> _closed;
     std::function<std::pair<tcp::socket*, uint32>()> _socketFactory;
+    std::function<bool(boost::asio::ip::address const&)> _acceptFilter;
 };
 
 #endif /* __ASYNCACCEPT_H_ */
@@ -23,7 +23,10 @@
 #include "Errors.h"
 #include "IoContext.h"
 #include "Log.h"
+#include "Socket.h"
+#include "SocketTimerWheel.h"
 #include "Timer.h"
+#include <array>
 #include <atomic>
 #include <boost/asio/ip/tcp.hpp>
 #include <chrono>
@@ -92,6 +95,8 @@ public:
 
     tcp::socket* GetSocketForAccept() { return &_acceptSocket; }
 
+    uint64 GetReapedSocketsCount(SocketTimeoutReason reason) const { return _reapedSockets[static_cast<std::size_t>(reason)]; }
+
 protected:
     virtual void SocketAdded(std::shared_ptr<SocketType> /*sock*/) { }
     virtual void SocketRemoved(std::shared_ptr<SocketType> /*sock*/) { }
@@ -111,7 +116,10 @@ protected:
                 --_connections;
             }
             else
+            {
                 _sockets.push_back(sock);
+                _timerWheel.Add(sock);
+            }
         }
 
         _newSockets.clear();
@@ -140,6 +148,14 @@ protected:
 
         AddNewSockets();
 
+        _timerWheel.Update(std::chrono::steady_clock::now(), [this](std::shared_ptr<SocketType> const& sock, SocketTimeoutReason reason)
+        {
+            ++_reapedSockets[static_cast<std::size_t>(reason)];
+
+            LOG_DEBUG("network", "Network Thread: close {} after deadline (reason {})", sock->GetRemoteIpAddress().to_string(), static_cast<uint32>(reason));
+            sock->CloseSocket();
+        });
+
         _sockets.erase(std::remove_if(_sockets.begin(), _sockets.end(), [this](std::shared_ptr<SocketType> sock)
         {
             if (!sock->Update())
@@ -166,6 +182,8 @@ private:
     std::thread* _thread;
 
     SocketContainer _sockets;
+    SocketTimerWheel<SocketType> _timerWheel;
+    std::array<std::atomic<uint64>, static_cast<std::size_t>(SocketTimeoutReason::Max)> _reapedSockets{};
 
     std::mutex _newSocketsLock;
     SocketContainer _newSockets;
@@ -18,6 +18,7 @@
 #ifndef __SOCKET_H__
 #define __SOCKET_H__
 
+#include "Duration.h"
 #include "Log.h"
 #include "MessageBuffer.h"
 #include <atomic>
@@ -33,12 +34,23 @@ using boost::asio::ip::tcp;
 #define WH_SOCKET_USE_IOCP
 #endif
 
+// State of socket which deadline is tracked in network thread
+enum class SocketTimeoutReason : uint8
+{
+    Handshake,
+    Auth,
+    Ping,
+
+    Max
+};
+
 template<class T>
 class Socket : public std::enable_shared_from_this<T>
 {
 public:
     explicit Socket(tcp::socket&& socket) : _socket(std::move(socket)), _remoteAddress(_socket.remote_endpoint().address()),
-        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false)
+        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false),
+        _deadline(TimePoint::max().time_since_epoch().count()), _deadlineReason(SocketTimeoutReason::Handshake)
     {
         _readBuffer.Resize(READ_BLOCK_SIZE);
     }
@@ -129,6 +141,17 @@ public:
     /// Marks the socket for closing after write buffer becomes empty
     void DelayedCloseSocket() { _closing = true; }
 
+    /// Socket is closed by network thread after deadline, 0s - without deadline
+    void SetDeadline(Milliseconds timeout, SocketTimeoutReason reason)
+    {
+        TimePoint deadline = timeout > 0ms ? std::chrono::steady_clock::now() + timeout : TimePoint::max();
+        _deadlineReason = reason;
+        _deadline = deadline.time_since_epoch().count();
+    }
+
+    TimePoint GetDeadline() const { return TimePoint(TimePoint::duration(_deadline.load())); }
+    SocketTimeoutReason GetDeadlineReason() const { return _deadlineReason; }
+
     MessageBuffer& GetReadBuffer() { return _readBuffer; }
 
 protected:
@@ -164,6 +187,9 @@ protected:
                 GetRemoteIpAddress().to_string(), err.value(), err.message());
     }
 
+    // Executor of the network thread owning this socket
+    auto GetIoExecutor() { return _socket.get_executor(); }
+
 private:
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
@@ -264,6 +290,10 @@ private:
     std::atomic<bool> _closing;
 
     bool _isWritingAsync;
+
+    // Can be changed from other threads, read by network thread
+    std::atomic<TimePoint::rep> _deadline;
+    std::atomic<SocketTimeoutReason> _deadlineReason;
 };
 
 #endif // __SOCKET_H__
@@ -97,21 +97,21 @@ public:
 
     virtual void OnSocketOpen(tcp::socket&& sock, uint32 threadIndex)
     {
-        try
-        {
-            std::shared_ptr<SocketType> newSocket = std::make_shared<SocketType>(std::move(sock));
-            newSocket->Start();
-
-            _threads[threadIndex].AddSocket(newSocket);
-        }
-        catch (boost::system::system_error const& err)
-        {
-            LOG_WARN("network", "Failed to retrieve client's remote address {}", err.what());
-        }
+        StartSocket(std::move(sock), threadIndex);
     }
 
     int32 GetNetworkThreadCount() const { return _threadCount; }
 
+    uint64 GetReapedSocketsCount(SocketTimeoutReason reason) const
+    {
+        uint64 count = 0;
+
+        for (int32 i = 0; i < _threadCount; ++i)
+            count += _threads[i].GetReapedSocketsCount(reason);
+
+        return count;
+    }
+
     uint32 SelectThreadWithMinConnections() const
     {
         uint32 min = 0;
@@ -135,6 +135,24 @@ protected:
 
     virtual NetworkThread<SocketType>* CreateThreads() const = 0;
 
+    bool StartSocket(tcp::socket&& sock, uint32 threadIndex)
+    {
+        try
+        {
+            std::shared_ptr<SocketType> newSocket = std::make_shared<SocketType>(std::move(sock));
+            newSocket->Start();
+
+            _threads[threadIndex].AddSocket(newSocket);
+            return true;
+        }
+        catch (boost::system::system_error const& err)
+        {
+            LOG_WARN("network", "Failed to retrieve client's remote address {}", err.what());
+        }
+
+        return false;
+    }
+
     AsyncAcceptor* _acceptor;
     NetworkThread<SocketType>* _threads;
     int32 _threadCount;
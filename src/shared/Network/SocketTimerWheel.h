@@ -0,0 +1,110 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOCKET_TIMER_WHEEL_H_
+#define _SOCKET_TIMER_WHEEL_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+// Hashed timer wheel with 1 second ticks for socket deadlines.
+// Deadline is read from socket only when its slot is reached, so socket can move it without touching the wheel
+template<class SocketType>
+class SocketTimerWheel
+{
+public:
+    static constexpr std::size_t SLOTS_COUNT = 256;
+
+    SocketTimerWheel() : _startTime(std::chrono::steady_clock::now()), _currentTick(0) { }
+
+    void Add(std::shared_ptr<SocketType> const& sock)
+    {
+        Schedule(sock, sock->GetDeadline());
+    }
+
+    // reap is called for sockets with expired deadline
+    template<typename Reap>
+    void Update(TimePoint now, Reap&& reap)
+    {
+        uint64 targetTick = ToTick(now);
+
+        while (_currentTick < targetTick)
+        {
+            ++_currentTick;
+
+            auto& slot = _slots[_currentTick % SLOTS_COUNT];
+            if (slot.empty())
+                continue;
+
+            std::vector<Entry> entries{ std::move(slot) };
+            slot.clear();
+
+            for (auto& entry : entries)
+            {
+                std::shared_ptr<SocketType> sock = entry.Socket.lock();
+                if (!sock || !sock->IsOpen())
+                    continue;
+
+                // Next round of the wheel
+                if (entry.Tick > _currentTick)
+                {
+                    slot.emplace_back(std::move(entry));
+                    continue;
+                }
+
+                TimePoint deadline = sock->GetDeadline();
+                if (deadline <= now)
+                    reap(sock, sock->GetDeadlineReason());
+                else
+                    Schedule(sock, deadline);
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<SocketType> Socket;
+        uint64 Tick{ 0 };
+    };
+
+    uint64 ToTick(TimePoint time) const
+    {
+        if (time <= _startTime)
+            return 0;
+
+        return std::chrono::duration_cast<Seconds>(time - _startTime).count();
+    }
+
+    void Schedule(std::shared_ptr<SocketType> const& sock, TimePoint deadline)
+    {
+        // Without deadline recheck once per wheel round, deadline can be set later
+        uint64 tick = deadline == TimePoint::max() ? _currentTick + SLOTS_COUNT : ToTick(deadline) + 1;
+        tick = std::max(tick, _currentTick + 1);
+
+        _slots[tick % SLOTS_COUNT].emplace_back(Entry{ sock, tick });
+    }
+
+    TimePoint _startTime;
+    uint64 _currentTick;
+    std::array<std::vector<Entry>, SLOTS_COUNT> _slots;
+};
+
+#endif
@@ -38,13 +38,17 @@ WH_API_EXPORT EnumText EnumUtils<DiscordCode>::ToString(DiscordCode value)
         case DiscordCode::CLIENT_SEND_PING: return { "CLIENT_SEND_PING", "CLIENT_SEND_PING", "" };
         case DiscordCode::SERVER_SEND_AUTH_RESPONSE: return { "SERVER_SEND_AUTH_RESPONSE", "SERVER_SEND_AUTH_RESPONSE", "" };
         case DiscordCode::SERVER_SEND_PONG: return { "SERVER_SEND_PONG", "SERVER_SEND_PONG", "" };
+        case DiscordCode::CLIENT_SEND_EVENT: return { "CLIENT_SEND_EVENT", "CLIENT_SEND_EVENT", "" };
+        case DiscordCode::SERVER_SEND_MESSAGE_ACK: return { "SERVER_SEND_MESSAGE_ACK", "SERVER_SEND_MESSAGE_ACK", "" };
+        case DiscordCode::SERVER_SEND_THROTTLE: return { "SERVER_SEND_THROTTLE", "SERVER_SEND_THROTTLE", "" };
+        case DiscordCode::CLIENT_RESUME_SESSION: return { "CLIENT_RESUME_SESSION", "CLIENT_RESUME_SESSION", "" };
         case DiscordCode::MAX_DISCORD_CODE: return { "MAX_DISCORD_CODE", "MAX_DISCORD_CODE", "" };
         default: throw std::out_of_range("value");
     }
 }
 
 template<>
-WH_API_EXPORT size_t EnumUtils<DiscordCode>::Count() { return 8; }
+WH_API_EXPORT size_t EnumUtils<DiscordCode>::Count() { return 12; }
 
 template<>
 WH_API_EXPORT DiscordCode EnumUtils<DiscordCode>::FromIndex(size_t index)
@@ -58,7 +62,11 @@ WH_API_EXPORT DiscordCode EnumUtils<DiscordCode>::FromIndex(size_t index)
         case 4: return DiscordCode::CLIENT_SEND_PING;
         case 5: return DiscordCode::SERVER_SEND_AUTH_RESPONSE;
         case 6: return DiscordCode::SERVER_SEND_PONG;
-        case 7: return DiscordCode::MAX_DISCORD_CODE;
+        case 7: return DiscordCode::CLIENT_SEND_EVENT;
+        case 8: return DiscordCode::SERVER_SEND_MESSAGE_ACK;
+        case 9: return DiscordCode::SERVER_SEND_THROTTLE;
+        case 10: return DiscordCode::CLIENT_RESUME_SESSION;
+        case 11: return DiscordCode::MAX_DISCORD_CODE;
         default: throw std::out_of_range("index");
     }
 }
@@ -75,7 +83,11 @@ WH_API_EXPORT size_t EnumUtils<DiscordCode>::ToIndex(DiscordCode value)
         case DiscordCode::CLIENT_SEND_PING: return 4;
         case DiscordCode::SERVER_SEND_AUTH_RESPONSE: return 5;
         case DiscordCode::SERVER_SEND_PONG: return 6;
-        case DiscordCode::MAX_DISCORD_CODE: return 7;
+        case DiscordCode::CLIENT_SEND_EVENT: return 7;
+        case DiscordCode::SERVER_SEND_MESSAGE_ACK: return 8;
+        case DiscordCode::SERVER_SEND_THROTTLE: return 9;
+        case DiscordCode::CLIENT_RESUME_SESSION: return 10;
+        case DiscordCode::MAX_DISCORD_CODE: return 11;
         default: throw std::out_of_range("value");
     }
 }
@@ -100,12 +112,13 @@ WH_API_EXPORT EnumText EnumUtils<DiscordAuthResponseCodes>::ToString(DiscordAuth
         case DiscordAuthResponseCodes::BotNotFound: return { "BotNotFound", "BotNotFound", "" };
         case DiscordAuthResponseCodes::ChannelsNotFound: return { "ChannelsNotFound", "ChannelsNotFound", "" };
         case DiscordAuthResponseCodes::ChannelsIncorrect: return { "ChannelsIncorrect", "ChannelsIncorrect", "" };
+        case DiscordAuthResponseCodes::ResumeFailed: return { "ResumeFailed", "ResumeFailed", "" };
         default: throw std::out_of_range("value");
     }
 }
 
 template<>
-WH_API_EXPORT size_t EnumUtils<DiscordAuthResponseCodes>::Count() { return 12; }
+WH_API_EXPORT size_t EnumUtils<DiscordAuthResponseCodes>::Count() { return 13; }
 
 template<>
 WH_API_EXPORT DiscordAuthResponseCodes EnumUtils<DiscordAuthResponseCodes>::FromIndex(size_t index)
@@ -124,6 +137,7 @@ WH_API_EXPORT DiscordAuthResponseCodes EnumUtils<DiscordAuthResponseCodes>::From
         case 9: return DiscordAuthResponseCodes::BotNotFound;
         case 10: return DiscordAuthResponseCodes::ChannelsNotFound;
         case 11: return DiscordAuthResponseCodes::ChannelsIncorrect;
+        case 12: return DiscordAuthResponseCodes::ResumeFailed;
         default: throw std::out_of_range("index");
     }
 }
@@ -145,6 +159,7 @@ WH_API_EXPORT size_t EnumUtils<DiscordAuthResponseCodes>::ToIndex(DiscordAuthRes
         case DiscordAuthResponseCodes::BotNotFound: return 9;
         case DiscordAuthResponseCodes::ChannelsNotFound: return 10;
         case DiscordAuthResponseCodes::ChannelsIncorrect: return 11;
+        case DiscordAuthResponseCodes::ResumeFailed: return 12;
         default: throw std::out_of_range("value");
     }
 }